@@ -50,7 +50,8 @@ if ( $compile -or $cleanAndCompile -or $compileAndRun -or $all ) {
         -lraylib `
         -lopengl32 `
         -lgdi32 `
-        -lwinmm
+        -lwinmm `
+        -lpthread
 }
 
 # run
@@ -0,0 +1,257 @@
+/**
+ * @file Benchmark.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless benchmark runner implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "Benchmark.h"
+#include "GameInput.h"
+#include "GameWorld.h"
+#include "InputRecord.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "WorldFile.h"
+#include "raylib/raylib.h"
+
+static GameInput createScriptedInput( BenchmarkConfig *config, int step );
+static uint32_t hashBytes( uint32_t hash, const void *data, size_t size );
+static uint32_t checksumGameWorld( GameWorld *gw );
+
+/**
+ * @brief Default configuration: 600 steps of 1/60 s on a 800x450 world,
+ * using every processor.
+ */
+BenchmarkConfig createBenchmarkConfig( void ) {
+    return (BenchmarkConfig) {
+        .steps = 600,
+        .delta = 1.0f / 60.0f,
+        .width = 800,
+        .height = 450,
+        .seed = 1,
+        .threadQuantity = 0,
+        .scriptedInput = false,
+        .obstaclesFile = NULL,
+        .tileSize = 0.0f,
+        .traceFrames = 0,
+        .worldFile = NULL,
+        .savedWorldFile = NULL,
+        .recordFile = NULL,
+        .replayFile = NULL
+    };
+}
+
+/**
+ * @brief Runs the world for config.steps fixed steps without opening a
+ * window and prints the per phase timings and the throughput to stdout.
+ */
+void runBenchmark( BenchmarkConfig config ) {
+
+    if ( config.replayFile != NULL ) {
+
+        InputRecord *replay = openInputRecord( config.replayFile );
+
+        if ( replay == NULL ) {
+            fprintf( stderr, "can't read the input recording %s\n", config.replayFile );
+            return;
+        }
+
+        InputRecordHeader header = getHeaderInputRecord( replay );
+        closeInputRecord( replay );
+
+        config.steps = header.stepQuantity;
+        config.width = header.width;
+        config.height = header.height;
+
+    }
+
+    GameWorld *gw = createGameWorld( config.width, config.height );
+    setSeedGameWorld( gw, config.seed );
+    setThreadQuantityGameWorld( gw, config.threadQuantity );
+
+    if ( config.obstaclesFile != NULL && !loadObstacleData( gw, config.obstaclesFile ) ) {
+        fprintf( stderr, "can't load obstacles from %s\n", config.obstaclesFile );
+        destroyGameWorld( gw );
+        return;
+    }
+
+    if ( config.replayFile != NULL ) {
+        if ( !startReplayGameWorld( gw, config.replayFile ) ) {
+            fprintf( stderr, "can't replay %s\n", config.replayFile );
+            destroyGameWorld( gw );
+            return;
+        }
+    } else {
+        setTileMapGameWorld( gw, config.tileSize );
+    }
+
+    if ( config.worldFile != NULL && !loadWorldFile( gw, config.worldFile ) ) {
+        fprintf( stderr, "can't load the world snapshot %s\n", config.worldFile );
+        destroyGameWorld( gw );
+        return;
+    }
+
+    if ( config.recordFile != NULL && !startRecordingGameWorld( gw, config.recordFile ) ) {
+        fprintf( stderr, "can't write the input recording %s\n", config.recordFile );
+        destroyGameWorld( gw );
+        return;
+    }
+
+    resetProfiler();
+    startTrace( TRACE_FILE, config.traceFrames );
+
+    long long particleUpdates = 0;
+    long long sleepingParticles = 0;
+    double startTime = getTimePlatform();
+
+    for ( int i = 0; i < config.steps; i++ ) {
+
+        GameInput input = { 0 };
+
+        if ( config.scriptedInput ) {
+            input = createScriptedInput( &config, i );
+        } else {
+            input.delta = config.delta;
+            input.screenWidth = config.width;
+            input.screenHeight = config.height;
+            input.mousePos = (Vector2) { -1.0f, -1.0f };
+        }
+
+        double traceStart = beginTraceZone();
+        updateGameWorld( gw, &input );
+        endTraceZone( "step", traceStart );
+        endFrameTrace();
+
+        // sleeping particles aren't updated
+        for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+            ParticleStore *ps = &gw->emitters[k]->particles;
+            particleUpdates += ps->awake;
+            sleepingParticles += ps->quantity - ps->awake;
+        }
+
+    }
+
+    double totalTime = getTimePlatform() - startTime;
+    stopTrace();
+
+    if ( config.savedWorldFile != NULL ) {
+        double saveStart = getTimePlatform();
+        if ( saveWorldFile( gw, config.savedWorldFile ) ) {
+            printf( "world saved to %s in %.3f ms\n", config.savedWorldFile, ( getTimePlatform() - saveStart ) * 1000.0 );
+        } else {
+            fprintf( stderr, "can't write the world snapshot %s\n", config.savedWorldFile );
+        }
+    }
+
+    if ( config.replayFile != NULL ) {
+        printf( "steps: %d (replaying %s)\n", config.steps, config.replayFile );
+    } else {
+        printf( "steps: %d (delta: %.4f s, %s input)\n", config.steps, config.delta, config.scriptedInput ? "scripted" : "no" );
+    }
+    if ( gw->useTileMap ) {
+        printf( "tiles: %d (%.0f px), threads: %d\n", gw->tileMap.solidQuantity, gw->tileMap.tileSize, getThreadQuantityWorkerPool( gw->workerPool ) );
+    } else {
+        printf( "obstacles: %d, threads: %d\n", gw->obstacleQuantity, getThreadQuantityWorkerPool( gw->workerPool ) );
+    }
+    printf( "%-12s %12s %12s %8s\n", "phase", "total (ms)", "step (us)", "share" );
+
+    for ( int i = 0; i < PROFILER_ZONE_COUNT; i++ ) {
+
+        // drawing zones never run headless
+        if ( profiler.calls[i] == 0 ) {
+            continue;
+        }
+
+        printf(
+            "%-12s %12.3f %12.3f %7.1f%%\n",
+            getNameProfilerZone( (ProfilerZone) i ),
+            profiler.total[i] * 1000.0,
+            profiler.total[i] * 1e6 / config.steps,
+            totalTime > 0.0 ? profiler.total[i] * 100.0 / totalTime : 0.0
+        );
+
+    }
+
+    printf( "%-12s %12.3f %12.3f\n", "total", totalTime * 1000.0, totalTime * 1e6 / config.steps );
+    printf( "particle updates: %lld (%lld skipped while sleeping)\n", particleUpdates, sleepingParticles );
+    printf( "throughput: %.0f particle updates/s\n", totalTime > 0.0 ? particleUpdates / totalTime : 0.0 );
+    printf( "state checksum: %08x\n", (unsigned int) checksumGameWorld( gw ) );
+
+    destroyGameWorld( gw );
+
+}
+
+/**
+ * @brief Sweeps the mouse around the center of the world. Paints obstacles
+ * with the right button during the first two seconds and then alternates
+ * one second bursts of the left button.
+ */
+static GameInput createScriptedInput( BenchmarkConfig *config, int step ) {
+
+    float t = step * config->delta;
+    int paintSteps = (int) ( 2.0f / config->delta );
+    int burstSteps = (int) ( 1.0f / config->delta ) + 1;
+    bool leftDown = step >= paintSteps && ( ( step - paintSteps ) / burstSteps ) % 2 == 1;
+    bool leftDownBefore = step - 1 >= paintSteps && ( ( step - 1 - paintSteps ) / burstSteps ) % 2 == 1;
+
+    return (GameInput) {
+        .delta = config->delta,
+        .screenWidth = config->width,
+        .screenHeight = config->height,
+        .mousePos = {
+            config->width * ( 0.5f + 0.3f * cosf( t ) ),
+            config->height * ( 0.5f + 0.3f * sinf( t * 2.0f ) )
+        },
+        .mouseLeftDown = leftDown,
+        .mouseLeftPressed = leftDown && !leftDownBefore,
+        .mouseLeftReleased = !leftDown && leftDownBefore,
+        .mouseRightDown = step < paintSteps
+    };
+
+}
+
+/**
+ * @brief FNV-1a.
+ */
+static uint32_t hashBytes( uint32_t hash, const void *data, size_t size ) {
+    const unsigned char *bytes = (const unsigned char*) data;
+    for ( size_t i = 0; i < size; i++ ) {
+        hash = ( hash ^ bytes[i] ) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hashes the particle and obstacle state, so runs can be compared.
+ */
+static uint32_t checksumGameWorld( GameWorld *gw ) {
+
+    uint32_t hash = 2166136261u;
+
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        ParticleStore *ps = &gw->emitters[k]->particles;
+        hash = hashBytes( hash, &ps->quantity, sizeof( int ) );
+        hash = hashBytes( hash, ps->x, ps->quantity * sizeof( float ) );
+        hash = hashBytes( hash, ps->y, ps->quantity * sizeof( float ) );
+        hash = hashBytes( hash, ps->vx, ps->quantity * sizeof( float ) );
+        hash = hashBytes( hash, ps->vy, ps->quantity * sizeof( float ) );
+    }
+
+    if ( gw->useTileMap ) {
+        hash = hashBytes( hash, gw->tileMap.tiles, (size_t) gw->tileMap.columns * gw->tileMap.rows );
+    } else {
+        for ( int i = 0; i < gw->obstacleQuantity; i++ ) {
+            hash = hashBytes( hash, &gw->obstacles[i].rect, sizeof( Rectangle ) );
+        }
+    }
+
+    return hash;
+
+}
\ No newline at end of file
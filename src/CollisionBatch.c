@@ -0,0 +1,156 @@
+/**
+ * @file CollisionBatch.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Batched circle versus rectangle test implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <math.h>
+
+#include "CollisionBatch.h"
+#include "raylib/raylib.h"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define COLLISION_X86_SIMD
+#include <immintrin.h>
+#endif
+
+static unsigned int testRectangleScalar( const float *x, const float *y, const float *radius, int start, int end, Rectangle rect );
+
+#ifdef COLLISION_X86_SIMD
+static unsigned int testRectangleSSE( const float *x, const float *y, const float *radius, int count, Rectangle rect );
+static unsigned int testRectangleAVX( const float *x, const float *y, const float *radius, int count, Rectangle rect );
+static unsigned int testRectangleAVX512( const float *x, const float *y, const float *radius, int count, Rectangle rect );
+#endif
+
+unsigned int testRectangleCollisionBatch( const float *x, const float *y, const float *radius, int count, Rectangle rect ) {
+
+#ifdef COLLISION_X86_SIMD
+    // 2 for AVX-512, 1 for AVX, 0 for SSE, detected by the first call
+    static int support = -1;
+    int level = __atomic_load_n( &support, __ATOMIC_RELAXED );
+    if ( level < 0 ) {
+        level = __builtin_cpu_supports( "avx512f" ) ? 2 : __builtin_cpu_supports( "avx" ) ? 1 : 0;
+        __atomic_store_n( &support, level, __ATOMIC_RELAXED );
+    }
+    if ( level == 2 ) {
+        return testRectangleAVX512( x, y, radius, count, rect );
+    } else if ( level == 1 ) {
+        return testRectangleAVX( x, y, radius, count, rect );
+    }
+    return testRectangleSSE( x, y, radius, count, rect );
+#else
+    return testRectangleScalar( x, y, radius, 0, count, rect );
+#endif
+
+}
+
+/**
+ * @brief Tests the circles in [start, end), setting their bits.
+ */
+static unsigned int testRectangleScalar( const float *x, const float *y, const float *radius, int start, int end, Rectangle rect ) {
+
+    float right = rect.x + rect.width;
+    float bottom = rect.y + rect.height;
+    unsigned int hits = 0;
+
+    for ( int i = start; i < end; i++ ) {
+        float dx = x[i] - fminf( fmaxf( x[i], rect.x ), right );
+        float dy = y[i] - fminf( fmaxf( y[i], rect.y ), bottom );
+        if ( dx * dx + dy * dy <= radius[i] * radius[i] ) {
+            hits |= 1u << i;
+        }
+    }
+
+    return hits;
+
+}
+
+#ifdef COLLISION_X86_SIMD
+
+static unsigned int testRectangleSSE( const float *x, const float *y, const float *radius, int count, Rectangle rect ) {
+
+    __m128 left = _mm_set1_ps( rect.x );
+    __m128 top = _mm_set1_ps( rect.y );
+    __m128 right = _mm_set1_ps( rect.x + rect.width );
+    __m128 bottom = _mm_set1_ps( rect.y + rect.height );
+
+    unsigned int hits = 0;
+    int i = 0;
+
+    for ( ; i + 4 <= count; i += 4 ) {
+
+        __m128 cx = _mm_loadu_ps( x + i );
+        __m128 cy = _mm_loadu_ps( y + i );
+        __m128 r = _mm_loadu_ps( radius + i );
+
+        __m128 dx = _mm_sub_ps( cx, _mm_min_ps( _mm_max_ps( cx, left ), right ) );
+        __m128 dy = _mm_sub_ps( cy, _mm_min_ps( _mm_max_ps( cy, top ), bottom ) );
+        __m128 distance = _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) );
+
+        hits |= (unsigned int) _mm_movemask_ps( _mm_cmple_ps( distance, _mm_mul_ps( r, r ) ) ) << i;
+
+    }
+
+    return hits | testRectangleScalar( x, y, radius, i, count, rect );
+
+}
+
+__attribute__(( target( "avx" ) ))
+static unsigned int testRectangleAVX( const float *x, const float *y, const float *radius, int count, Rectangle rect ) {
+
+    __m256 left = _mm256_set1_ps( rect.x );
+    __m256 top = _mm256_set1_ps( rect.y );
+    __m256 right = _mm256_set1_ps( rect.x + rect.width );
+    __m256 bottom = _mm256_set1_ps( rect.y + rect.height );
+
+    unsigned int hits = 0;
+    int i = 0;
+
+    for ( ; i + 8 <= count; i += 8 ) {
+
+        __m256 cx = _mm256_loadu_ps( x + i );
+        __m256 cy = _mm256_loadu_ps( y + i );
+        __m256 r = _mm256_loadu_ps( radius + i );
+
+        __m256 dx = _mm256_sub_ps( cx, _mm256_min_ps( _mm256_max_ps( cx, left ), right ) );
+        __m256 dy = _mm256_sub_ps( cy, _mm256_min_ps( _mm256_max_ps( cy, top ), bottom ) );
+        __m256 distance = _mm256_add_ps( _mm256_mul_ps( dx, dx ), _mm256_mul_ps( dy, dy ) );
+
+        hits |= (unsigned int) _mm256_movemask_ps( _mm256_cmp_ps( distance, _mm256_mul_ps( r, r ), _CMP_LE_OQ ) ) << i;
+
+    }
+
+    // the caller runs SSE code, which stalls while the upper halves of
+    // the registers are dirty
+    _mm256_zeroupper();
+
+    return hits | testRectangleScalar( x, y, radius, i, count, rect );
+
+}
+
+/**
+ * @brief The whole batch in one pass, the lanes past count are masked off
+ * and never loaded.
+ */
+__attribute__(( target( "avx512f" ) ))
+static unsigned int testRectangleAVX512( const float *x, const float *y, const float *radius, int count, Rectangle rect ) {
+
+    __mmask16 lanes = (__mmask16) ( ( 1u << count ) - 1 );
+
+    __m512 cx = _mm512_maskz_loadu_ps( lanes, x );
+    __m512 cy = _mm512_maskz_loadu_ps( lanes, y );
+    __m512 r = _mm512_maskz_loadu_ps( lanes, radius );
+
+    __m512 dx = _mm512_sub_ps( cx, _mm512_min_ps( _mm512_max_ps( cx, _mm512_set1_ps( rect.x ) ), _mm512_set1_ps( rect.x + rect.width ) ) );
+    __m512 dy = _mm512_sub_ps( cy, _mm512_min_ps( _mm512_max_ps( cy, _mm512_set1_ps( rect.y ) ), _mm512_set1_ps( rect.y + rect.height ) ) );
+    __m512 distance = _mm512_add_ps( _mm512_mul_ps( dx, dx ), _mm512_mul_ps( dy, dy ) );
+
+    unsigned int hits = _mm512_mask_cmp_ps_mask( lanes, distance, _mm512_mul_ps( r, r ), _CMP_LE_OQ );
+    _mm256_zeroupper();
+
+    return hits;
+
+}
+
+#endif
\ No newline at end of file
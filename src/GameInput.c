@@ -0,0 +1,160 @@
+/**
+ * @file GameInput.c
+ * @author Prof. Dr. David Buzatto
+ * @brief GameInput implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+
+#include "GameInput.h"
+#include "raylib/raylib.h"
+
+/**
+ * @brief Polls raylib for the current frame input.
+ */
+GameInput readGameInput( void ) {
+
+    GameInput input = {
+        .delta = GetFrameTime(),
+        .screenWidth = GetScreenWidth(),
+        .screenHeight = GetScreenHeight(),
+        .mousePos = GetMousePosition(),
+        .mouseWheelMove = GetMouseWheelMove(),
+        .mouseLeftDown = IsMouseButtonDown( MOUSE_BUTTON_LEFT ),
+        .mouseLeftPressed = IsMouseButtonPressed( MOUSE_BUTTON_LEFT ),
+        .mouseLeftReleased = IsMouseButtonReleased( MOUSE_BUTTON_LEFT ),
+        .mouseRightDown = IsMouseButtonDown( MOUSE_BUTTON_RIGHT ),
+        .actions = 0
+    };
+
+    if ( IsKeyPressed( KEY_F1 ) ) {
+        input.actions |= GAME_ACTION_TOGGLE_INFO;
+    }
+
+    if ( IsKeyPressed( KEY_F2 ) ) {
+        input.actions |= GAME_ACTION_SAVE_PROFILER;
+    }
+
+    if ( IsKeyPressed( KEY_F3 ) ) {
+        input.actions |= GAME_ACTION_START_TRACE;
+    }
+
+    if ( IsKeyPressed( KEY_F4 ) ) {
+        input.actions |= GAME_ACTION_TOGGLE_TILE_MAP;
+    }
+
+    if ( IsKeyPressed( KEY_F5 ) ) {
+        input.actions |= GAME_ACTION_SAVE_OBSTACLES;
+    }
+
+    if ( IsKeyPressed( KEY_F6 ) ) {
+        input.actions |= GAME_ACTION_LOAD_OBSTACLES;
+    }
+
+    if ( IsKeyPressed( KEY_F7 ) ) {
+        input.actions |= GAME_ACTION_RESET_OBSTACLES;
+    }
+
+    if ( IsKeyPressed( KEY_F8 ) ) {
+        input.actions |= GAME_ACTION_EXPORT_OBSTACLES;
+    }
+
+    if ( IsKeyPressed( KEY_F9 ) ) {
+        input.actions |= GAME_ACTION_SAVE_WORLD;
+    }
+
+    if ( IsKeyPressed( KEY_F10 ) ) {
+        input.actions |= GAME_ACTION_LOAD_WORLD;
+    }
+
+    if ( IsKeyPressed( KEY_UP ) ) {
+        input.actions |= GAME_ACTION_ZOOM_IN;
+    } else if ( IsKeyPressed( KEY_DOWN ) ) {
+        input.actions |= GAME_ACTION_ZOOM_OUT;
+    }
+
+    return input;
+
+}
+
+/**
+ * @brief Accumulates a newer input into an older one that wasn't consumed
+ * yet: events (actions, presses, releases, wheel) add up and the held
+ * state, mouse position, screen size and delta take the newer values.
+ */
+void mergeGameInput( GameInput *into, const GameInput *from ) {
+
+    into->delta = from->delta;
+    into->screenWidth = from->screenWidth;
+    into->screenHeight = from->screenHeight;
+    into->mousePos = from->mousePos;
+    into->mouseLeftDown = from->mouseLeftDown;
+    into->mouseRightDown = from->mouseRightDown;
+
+    into->mouseWheelMove += from->mouseWheelMove;
+    into->mouseLeftPressed = into->mouseLeftPressed || from->mouseLeftPressed;
+    into->mouseLeftReleased = into->mouseLeftReleased || from->mouseLeftReleased;
+    into->actions |= from->actions;
+
+}
+
+/**
+ * @brief Clears the events of an input after it was consumed, keeping the
+ * held state.
+ */
+void clearEventsGameInput( GameInput *input ) {
+    input->mouseWheelMove = 0.0f;
+    input->mouseLeftPressed = false;
+    input->mouseLeftReleased = false;
+    input->actions = 0;
+}
+
+/**
+ * @brief Returns true if the action was triggered in this input.
+ */
+bool hasGameAction( const GameInput *input, GameAction action ) {
+    return ( input->actions & action ) != 0;
+}
+
+/**
+ * @brief Appends an input to the queue. Returns false, without blocking,
+ * if the queue is full. Producer side only.
+ */
+bool pushGameInputQueue( GameInputQueue *queue, const GameInput *input ) {
+
+    unsigned int tail = __atomic_load_n( &queue->tail, __ATOMIC_RELAXED );
+    unsigned int head = __atomic_load_n( &queue->head, __ATOMIC_ACQUIRE );
+
+    if ( tail - head == GAME_INPUT_QUEUE_CAPACITY ) {
+        return false;
+    }
+
+    // the release publishes the input together with the new tail
+    queue->inputs[tail % GAME_INPUT_QUEUE_CAPACITY] = *input;
+    __atomic_store_n( &queue->tail, tail + 1, __ATOMIC_RELEASE );
+
+    return true;
+
+}
+
+/**
+ * @brief Takes the oldest input of the queue. Returns false, without
+ * blocking, if the queue is empty. Consumer side only.
+ */
+bool popGameInputQueue( GameInputQueue *queue, GameInput *input ) {
+
+    unsigned int head = __atomic_load_n( &queue->head, __ATOMIC_RELAXED );
+    unsigned int tail = __atomic_load_n( &queue->tail, __ATOMIC_ACQUIRE );
+
+    if ( head == tail ) {
+        return false;
+    }
+
+    // the release hands the slot back to the producer
+    *input = queue->inputs[head % GAME_INPUT_QUEUE_CAPACITY];
+    __atomic_store_n( &queue->head, head + 1, __ATOMIC_RELEASE );
+
+    return true;
+
+}
\ No newline at end of file
@@ -5,16 +5,26 @@
  * 
  * @copyright Copyright (c) 2024
  */
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 
 #include "GameWindow.h"
+#include "GameInput.h"
 #include "GameWorld.h"
+#include "InputRecord.h"
+#include "Profiler.h"
+#include "Trace.h"
 #include "ResourceManager.h"
+#include "SimulationThread.h"
+#include "WorldFile.h"
 #include "raylib/raylib.h"
 
 /**
  * @brief Creates a dinamically allocated GameWindow struct instance.
+ * The simulation runs at 60 steps per second, with up to 8 steps per
+ * frame, unless simulationRate and maxSubsteps are changed before
+ * initGameWindow.
  */
 GameWindow* createGameWindow( 
         int width, 
@@ -44,6 +54,14 @@ GameWindow* createGameWindow(
     gameWindow->alwaysRun = alwaysRun;
     gameWindow->loadResources = loadResources;
     gameWindow->initAudio = initAudio;
+    gameWindow->simulationRate = 60.0f;
+    gameWindow->maxSubsteps = 8;
+    gameWindow->threadQuantity = 0;
+    gameWindow->tileSize = 0.0f;
+    gameWindow->traceFrames = 0;
+    gameWindow->worldFile = NULL;
+    gameWindow->recordFile = NULL;
+    gameWindow->replayFile = NULL;
     gameWindow->gw = NULL;
     gameWindow->initialized = false;
 
@@ -97,21 +115,73 @@ void initGameWindow( GameWindow *gameWindow ) {
             loadResourcesResourceManager();
         }
 
-        gameWindow->gw = createGameWorld();
+        // a replayed world is built with the size it was recorded with
+        int worldWidth = GetScreenWidth();
+        int worldHeight = GetScreenHeight();
+        InputRecord *replay = gameWindow->replayFile != NULL ? openInputRecord( gameWindow->replayFile ) : NULL;
 
-        // game loop
-        while ( !WindowShouldClose() ) {
-            inputAndUpdateGameWorld( gameWindow->gw );
-            drawGameWorld( gameWindow->gw );
+        if ( replay != NULL ) {
+            worldWidth = getHeaderInputRecord( replay ).width;
+            worldHeight = getHeaderInputRecord( replay ).height;
+            closeInputRecord( replay );
         }
 
+        gameWindow->gw = createGameWorld( worldWidth, worldHeight );
+        setSimulationRateGameWorld( gameWindow->gw, gameWindow->simulationRate, gameWindow->maxSubsteps );
+        setThreadQuantityGameWorld( gameWindow->gw, gameWindow->threadQuantity );
+
+        if ( gameWindow->replayFile == NULL ) {
+            setTileMapGameWorld( gameWindow->gw, gameWindow->tileSize );
+        } else if ( !startReplayGameWorld( gameWindow->gw, gameWindow->replayFile ) ) {
+            fprintf( stderr, "can't replay %s\n", gameWindow->replayFile );
+        }
+
+        if ( gameWindow->worldFile != NULL && !loadWorldFile( gameWindow->gw, gameWindow->worldFile ) ) {
+            fprintf( stderr, "can't load the world snapshot %s\n", gameWindow->worldFile );
+        }
+
+        if ( gameWindow->recordFile != NULL && !startRecordingGameWorld( gameWindow->gw, gameWindow->recordFile ) ) {
+            fprintf( stderr, "can't write the input recording %s\n", gameWindow->recordFile );
+        }
+
+        startTrace( TRACE_FILE, gameWindow->traceFrames );
+
+        // game loop: the world steps in its own thread while this one
+        // reads the input and draws the last snapshot it published
+        SimulationThread *st = createSimulationThread( gameWindow->gw );
+
+        while ( st != NULL && !WindowShouldClose() ) {
+
+            double start = beginTraceZone();
+            GameInput input = readGameInput();
+            endTraceZone( "input", start );
+
+            handleWindowActionsGameWorld( &input );
+            pushInputSimulationThread( st, &input );
+
+            drawGameWorld( gameWindow->gw, getSnapshotSimulationThread( st ) );
+            endFrameProfiler();
+            endFrameTrace();
+
+        }
+
+        if ( st == NULL ) {
+            fprintf( stderr, "can't create the simulation thread\n" );
+        } else {
+            destroySimulationThread( st );
+        }
+
+        stopTrace();
+
         if ( gameWindow->loadResources ) {
             unloadResourcesResourceManager();
         }
 
+        // the world owns GPU resources, so it goes before the window
+        bool initAudio = gameWindow->initAudio;
         destroyGameWindow( gameWindow );
 
-        if ( gameWindow->initAudio ) {
+        if ( initAudio ) {
             CloseAudioDevice();
         }
 
@@ -10,10 +10,21 @@
 #include <stdbool.h>
 #include <math.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
 
 #include "GameWorld.h"
+#include "CollisionBatch.h"
+#include "GameInput.h"
+#include "ObstacleFile.h"
+#include "ObstacleLoader.h"
+#include "ObstacleSet.h"
 #include "ParticleEmitter.h"
+#include "Platform.h"
+#include "Profiler.h"
 #include "ResourceManager.h"
+#include "Trace.h"
+#include "WorldFile.h"
 #include "utils.h"
 
 #include "raylib/raylib.h"
@@ -22,18 +33,84 @@
 //#include "raylib/raygui.h"       // other compilation units must only include
 //#undef RAYGUI_IMPLEMENTATION     // raygui.h
 
+// obstacles gathered for a batch of particles before it falls back to
+// resolving them one by one
+#define COLLISION_BATCH_CANDIDATES 64
+
 const float GRAVITY = 20.0f;
-const char* OBSTACLES_FILE = "resources/obstacles/data.txt";
+const char* OBSTACLES_FILE = "resources/obstacles/data.bin";
+const char* OBSTACLES_TEXT_FILE = "resources/obstacles/data.txt";
+const char* PROFILER_FILE = "profiler.csv";
+const char* TRACE_FILE = "trace.json";
+const char* WORLD_FILE = "world.bin";
+const int TRACE_FRAMES = 300;
+const float OBSTACLE_GRID_CELL_SIZE = 40.0f;
+const float EMISSION_RATE = 300.0f;
+const int MIN_PARTICLES_PER_THREAD = 512;
+const float WORLD_BOUNDS_MARGIN = 100.0f;
+const float TILE_MAP_TILE_SIZE = 20.0f;
+const float TILE_MAP_WIDTH = 10240.0f;
+const float TILE_MAP_HEIGHT = 5120.0f;
+
+// the smallest painted obstacle: a particle that moves less than this in a
+// pass can't go through one, so only the passes of the emitters that hit
+// MAX_PARTICLE_SUBSTEPS need to be swept
+const float MAX_STEP_DISPLACEMENT = 20.0f;
+const int MAX_PARTICLE_SUBSTEPS = 8;
 
 float timeToNextObstacle = 0.1f;
-float nextObstacleCounter = 0.0f;
 bool showInfo = true;
-float currentZoom = 1.0f;
+
+typedef struct ParticleJob {
+    GameWorld *gw;
+    float delta;
+} ParticleJob;
+
+typedef enum ContactFace {
+    CONTACT_FACE_NONE   = 0,
+    CONTACT_FACE_TOP    = 1 << 0,
+    CONTACT_FACE_BOTTOM = 1 << 1,
+    CONTACT_FACE_LEFT   = 1 << 2,
+    CONTACT_FACE_RIGHT  = 1 << 3,
+    CONTACT_FACE_ALL    = 15
+} ContactFace;
+
+// earliest hit found while sweeping the path of a particle
+typedef struct ParticleSweep {
+    float time;           // fraction of the step, in [0, 1]
+    ContactFace face;
+    Rectangle rect;
+} ParticleSweep;
+
+static void updateParticleOffsets( GameWorld *gw, int pass );
+static int updateEmitterSubsteps( GameWorld *gw, float delta );
+static void copyStepStartPositions( GameWorld *gw, bool restore );
+static void wakeParticlesGameWorld( GameWorld *gw, const Rectangle *area );
+static void integrateParticlesTask( void *context, int start, int end, int part );
+static void resolveCollisionTask( void *context, int start, int end, int part );
+static void resolveParticleRangeCollision( GameWorld *gw, ParticleStore *ps, int start, int end );
+static void resolveParticleBatchCollision( GameWorld *gw, ParticleStore *ps, int start, int count );
+static void resolveParticleCollision( GameWorld *gw, ParticleStore *ps, int i );
+static void resolveParticleObstacleCollision( ParticleStore *ps, int i, Obstacle *o );
+static void resolveParticleRangeTileCollision( GameWorld *gw, ParticleStore *ps, int start, int end );
+static void resolveParticleTileCollision( ParticleStore *ps, int i, TileMap *tm, int column, int row );
+static void resolveParticleContact( ParticleStore *ps, int i, Rectangle rect, unsigned int faces );
+static void applyContactResponse( ParticleStore *ps, int i, Rectangle rect, ContactFace face );
+static unsigned int getOpenFacesTile( TileMap *tm, int column, int row );
+static bool isFastParticle( ParticleStore *ps, int i, float extent );
+static Rectangle getSweptBounds( ParticleStore *ps, int i );
+static void sweepParticleRectangle( ParticleStore *ps, int i, Rectangle rect, unsigned int faces, ParticleSweep *sweep );
+static void applyParticleSweep( ParticleStore *ps, int i, ParticleSweep *sweep );
+static void sweepParticleCollision( GameWorld *gw, ParticleStore *ps, int i );
+static void sweepParticleTileCollision( GameWorld *gw, ParticleStore *ps, int i );
+static void copyTilesToObstacles( GameWorld *gw );
+static void updateObstacleGrid( GameWorld *gw );
+static void drawObstacleLayer( GameWorld *gw, RenderSnapshot *rs );
 
 /**
  * @brief Creates a dinamically allocated GameWorld struct instance.
  */
-GameWorld* createGameWorld( void ) {
+GameWorld* createGameWorld( int width, int height ) {
 
     GameWorld *gw = (GameWorld*) malloc( sizeof( GameWorld ) );
 
@@ -60,7 +137,7 @@ GameWorld* createGameWorld( void ) {
     );
 
     gw->peStaticRight = createParticleEmitter( 
-        (Vector2) { 40.0f, GetScreenHeight() / 2 },
+        (Vector2) { 40.0f, height / 2 },
         (Vector2) { 0.0f, 0.0f },
         90.0f,
         0.0f,
@@ -71,7 +148,7 @@ GameWorld* createGameWorld( void ) {
     );
 
     gw->peStaticTop = createParticleEmitter( 
-        (Vector2) { GetScreenWidth() * 0.75f, GetScreenHeight() - 40 },
+        (Vector2) { width * 0.75f, height - 40 },
         (Vector2) { 0.0f, 0.0f },
         180.0f,
         0.0f,
@@ -87,15 +164,49 @@ GameWorld* createGameWorld( void ) {
     gw->emitters[1] = &gw->peMouseDown;
     gw->emitters[2] = &gw->peStaticRight;
     gw->emitters[3] = &gw->peStaticTop;
+    gw->particleOffsets = (int*) calloc( gw->emittersQuantity + 1, sizeof( int ) );
+    gw->emitterSubsteps = (int*) calloc( gw->emittersQuantity, sizeof( int ) );
+    gw->stepStartCapacity = 0;
+    gw->stepStartX = NULL;
+    gw->stepStartY = NULL;
+    gw->removedParticles = 0;
+    gw->width = width;
+    gw->height = height;
+    setSeedGameWorld( gw, (uint64_t) time( NULL ) );
+
+    gw->workerPool = NULL;
+    setThreadQuantityGameWorld( gw, 0 );
 
     gw->newObstaclePos = 0;
+    gw->obstacleCounter = 0.0f;
     gw->obstacleQuantity = 0;
     gw->maxObstacles = 400;
     gw->obstacles = (Obstacle*) malloc( gw->maxObstacles * sizeof( Obstacle ) );
+    gw->obstacleGrid = createObstacleGrid( OBSTACLE_GRID_CELL_SIZE );
+    gw->obstacleGridDirty = true;
+    gw->obstacleLoader = createObstacleLoader( OBSTACLE_GRID_CELL_SIZE );
+    gw->paintingObstacles = false;
+    gw->useTileMap = false;
+    gw->tileSize = TILE_MAP_TILE_SIZE;
+    gw->tileMap = (TileMap) { 0 };
+
+    gw->obstacleLayerDirty = true;
+    gw->obstacleLayerVersion = 0;
+    gw->obstacleLayerView = (Rectangle) { 0 };
+
+    gw->particleRenderer = (ParticleRenderer) { 0 };
+    gw->obstacleLayer = (RenderTexture2D) { 0 };
+    gw->drawnObstacleLayerVersion = 0;
+
+    gw->accumulator = 0.0f;
+    gw->pendingInput = (GameInput) { 0 };
+    gw->record = NULL;
+    gw->replay = NULL;
+    setSimulationRateGameWorld( gw, 60.0f, 8 );
 
     gw->camera = (Camera2D) {
-        .target = { GetScreenWidth() / 2, GetScreenHeight() / 2 },
-        .offset = { GetScreenWidth() / 2, GetScreenHeight() / 2 },
+        .target = { width / 2, height / 2 },
+        .offset = { width / 2, height / 2 },
         .rotation = 0.0f,
         .zoom = 1.0f
     };
@@ -108,19 +219,192 @@ GameWorld* createGameWorld( void ) {
  * @brief Destroys a GameWindow object and its dependecies.
  */
 void destroyGameWorld( GameWorld *gw ) {
-    destroyParticleEmitter( &gw->peMoveSin );
+    for ( int i = 0; i < gw->emittersQuantity; i++ ) {
+        destroyParticleEmitter( gw->emitters[i] );
+    }
+    free( gw->emitters );
+    free( gw->particleOffsets );
+    free( gw->emitterSubsteps );
+    free( gw->stepStartX );
+    free( gw->stepStartY );
+    destroyWorkerPool( gw->workerPool );
+    free( gw->obstacles );
+    destroyParticleRenderer( &gw->particleRenderer );
+    if ( gw->obstacleLayer.id != 0 ) {
+        UnloadRenderTexture( gw->obstacleLayer );
+    }
+    destroyObstacleGrid( &gw->obstacleGrid );
+    destroyObstacleLoader( gw->obstacleLoader );
+    destroyTileMap( &gw->tileMap );
+    closeInputRecord( gw->record );
+    closeInputRecord( gw->replay );
     free( gw );
 }
 
 /**
- * @brief Reads user input and updates the state of the game.
+ * @brief Seeds the random number generators of the emitters. Each emitter
+ * gets its own stream derived from seed.
+ */
+void setSeedGameWorld( GameWorld *gw, uint64_t seed ) {
+    gw->seed = seed;
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        setSeedParticleEmitter( gw->emitters[k], seed + k );
+    }
+}
+
+/**
+ * @brief Starts writing the input of every following step to fileName,
+ * with what is needed to replay them on a new world. Must be called before
+ * the first step. Returns false if the file can't be written.
+ */
+bool startRecordingGameWorld( GameWorld *gw, const char *fileName ) {
+
+    InputRecordHeader header = {
+        .seed = gw->seed,
+        .width = gw->width,
+        .height = gw->height,
+        .tileSize = gw->tileSize,
+        .useTileMap = gw->useTileMap
+    };
+
+    closeInputRecord( gw->record );
+    gw->record = createInputRecord( fileName, header );
+
+    return gw->record != NULL;
+
+}
+
+/**
+ * @brief Replaces the input of the following steps by the ones recorded in
+ * fileName, reseeding the world and choosing the obstacle backend of the
+ * recording. The world must be new and have the recorded size (see
+ * InputRecordHeader). Returns false if the recording can't be read or
+ * doesn't match the world.
+ */
+bool startReplayGameWorld( GameWorld *gw, const char *fileName ) {
+
+    InputRecord *replay = openInputRecord( fileName );
+
+    if ( replay == NULL ) {
+        return false;
+    }
+
+    InputRecordHeader header = getHeaderInputRecord( replay );
+
+    if ( header.width != gw->width || header.height != gw->height ) {
+        closeInputRecord( replay );
+        return false;
+    }
+
+    setSeedGameWorld( gw, header.seed );
+    setTileMapGameWorld( gw, 0.0f );
+    gw->tileSize = header.tileSize;
+    if ( header.useTileMap ) {
+        setTileMapGameWorld( gw, header.tileSize );
+    }
+
+    closeInputRecord( gw->replay );
+    gw->replay = replay;
+
+    return true;
+
+}
+
+/**
+ * @brief Handles the actions that belong to the window and not to the
+ * simulation (HUD, profiler and trace). Called by the thread that draws.
+ */
+void handleWindowActionsGameWorld( const GameInput *input ) {
+
+    if ( hasGameAction( input, GAME_ACTION_TOGGLE_INFO ) ) {
+        showInfo = !showInfo;
+    }
+
+    if ( hasGameAction( input, GAME_ACTION_SAVE_PROFILER ) ) {
+        saveCSVProfiler( PROFILER_FILE );
+    }
+
+    if ( hasGameAction( input, GAME_ACTION_START_TRACE ) ) {
+        startTrace( TRACE_FILE, TRACE_FRAMES );
+    }
+
+}
+
+/**
+ * @brief Advances the simulation by the frame time in input->delta, running
+ * as many fixed steps as fit in the accumulated time, up to maxSubsteps.
+ * Returns how many steps ran.
+ */
+int advanceGameWorld( GameWorld *gw, const GameInput *input ) {
+
+    // no step is running here, so a finished load can replace the obstacles
+    ObstacleSet set;
+    if ( takeObstacleLoader( gw->obstacleLoader, &set ) ) {
+        swapObstacleSetGameWorld( gw, &set );
+    }
+
+    // events of frames that didn't run a step are kept for the next one
+    mergeGameInput( &gw->pendingInput, input );
+    gw->pendingInput.delta = gw->fixedDelta;
+
+    gw->accumulator += input->delta;
+    int steps = 0;
+
+    while ( gw->accumulator >= gw->fixedDelta && steps < gw->maxSubsteps ) {
+        double start = beginTraceZone();
+        updateGameWorld( gw, &gw->pendingInput );
+        endTraceZone( "step", start );
+        clearEventsGameInput( &gw->pendingInput );
+        gw->accumulator -= gw->fixedDelta;
+        steps++;
+    }
+
+    // too far behind: drop the time that can't be simulated
+    if ( gw->accumulator >= gw->fixedDelta ) {
+        gw->accumulator = fmodf( gw->accumulator, gw->fixedDelta );
+    }
+
+    return steps;
+
+}
+
+/**
+ * @brief Runs one simulation step of input->delta seconds. Doesn't touch
+ * the window, so it can run headless. While replaying, input is ignored
+ * and the recorded one is used until the recording ends.
  */
-void inputAndUpdateGameWorld( GameWorld *gw ) {
+void updateGameWorld( GameWorld *gw, const GameInput *input ) {
+
+    GameInput replayed;
+
+    if ( gw->replay != NULL ) {
+        if ( readInputRecord( gw->replay, &replayed ) ) {
+            input = &replayed;
+        } else {
+            closeInputRecord( gw->replay );
+            gw->replay = NULL;
+        }
+    }
+
+    if ( gw->record != NULL ) {
+        writeInputRecord( gw->record, input );
+    }
+
+    // between the last step and this one, so the snapshot is consistent
+    if ( hasGameAction( input, GAME_ACTION_SAVE_WORLD ) ) {
+        saveWorldFile( gw, WORLD_FILE );
+    }
+
+    if ( hasGameAction( input, GAME_ACTION_LOAD_WORLD ) ) {
+        loadWorldFile( gw, WORLD_FILE );
+    }
+
+    float delta = input->delta;
 
-    float delta = GetFrameTime();
+    bool d1 = resolveParticleEmitterMouseOperations( &gw->peStaticRight, gw->camera, input );
+    bool d2 = resolveParticleEmitterMouseOperations( &gw->peStaticTop, gw->camera, input );
 
-    bool d1 = resolveParticleEmitterMouseOperations( &gw->peStaticRight, gw->camera );
-    bool d2 = resolveParticleEmitterMouseOperations( &gw->peStaticTop, gw->camera );
+    beginProfilerZone( PROFILER_ZONE_EMIT );
 
     emitParticleColorIntervalQuantity( 
         &gw->peMoveSin, 
@@ -129,18 +413,18 @@ void inputAndUpdateGameWorld( GameWorld *gw ) {
         true, false,
         2, 6,
         180.0f, 240.0f,
-        5
+        getEmissionQuantityParticleEmitter( &gw->peMoveSin, EMISSION_RATE, delta )
     );
 
-    if ( !d1 && !d2 && IsMouseButtonDown( MOUSE_BUTTON_LEFT ) ) {
+    if ( !d1 && !d2 && input->mouseLeftDown ) {
         emitParticlePolarPositionColorIntervalQuantity( 
             &gw->peMouseDown, 
-            GetScreenToWorld2D( GetMousePosition(), gw->camera ), 
+            GetScreenToWorld2D( input->mousePos, gw->camera ), 
             100, 200,
             0, 200, true,
             2, 6,
             0.0f, 60.0f,
-            5
+            getEmissionQuantityParticleEmitter( &gw->peMouseDown, EMISSION_RATE, delta )
         );
     }
 
@@ -150,7 +434,7 @@ void inputAndUpdateGameWorld( GameWorld *gw ) {
         0, 20, true,
         2, 6,
         75.0f, 165.0f, 
-        5
+        getEmissionQuantityParticleEmitter( &gw->peStaticRight, EMISSION_RATE, delta )
     );
 
     emitParticlePolarColorIntervalQuantity( 
@@ -159,96 +443,389 @@ void inputAndUpdateGameWorld( GameWorld *gw ) {
         0, 8, true,
         1, 3,
         270.0f, 330.0f, 
-        5
+        getEmissionQuantityParticleEmitter( &gw->peStaticTop, EMISSION_RATE, delta )
     );
 
-    updateParticleEmitterMoveSin( &gw->peMoveSin, delta );
+    endProfilerZone( PROFILER_ZONE_EMIT );
+
+    double start = beginTraceZone();
+    updateParticleEmitterMoveSin( &gw->peMoveSin, delta, input->screenWidth );
     updateParticleEmitterStatic( &gw->peMouseDown, delta );
     updateParticleEmitterStatic( &gw->peStaticRight, delta );
     updateParticleEmitterStatic( &gw->peStaticTop, delta );
+    endTraceZone( "emitters", start );
 
-    if ( IsMouseButtonDown( MOUSE_BUTTON_RIGHT ) ) {
-        createObstacleGameWorld( gw, delta, GetScreenToWorld2D( GetMousePosition(), gw->camera ) );
+    if ( input->mouseRightDown ) {
+        createObstacleGameWorld( gw, delta, GetScreenToWorld2D( input->mousePos, gw->camera ) );
+    } else if ( gw->paintingObstacles && !gw->useTileMap ) {
+        optimizeObstacles( gw );
     }
 
-    if ( IsKeyPressed( KEY_F1 ) ) {
-        showInfo = !showInfo;
+    gw->paintingObstacles = input->mouseRightDown;
+
+    if ( hasGameAction( input, GAME_ACTION_TOGGLE_TILE_MAP ) ) {
+        setTileMapGameWorld( gw, gw->useTileMap ? 0.0f : gw->tileSize );
     }
 
-    if ( IsKeyPressed( KEY_F5 ) ) {
+    if ( hasGameAction( input, GAME_ACTION_SAVE_OBSTACLES ) ) {
         saveObstacleData( gw, OBSTACLES_FILE );
     }
 
-    if ( IsKeyPressed( KEY_F6 ) ) {
-        loadObstacleData( gw, OBSTACLES_FILE );
+    if ( hasGameAction( input, GAME_ACTION_EXPORT_OBSTACLES ) ) {
+        exportObstacleData( gw, OBSTACLES_TEXT_FILE );
+    }
+
+    if ( hasGameAction( input, GAME_ACTION_LOAD_OBSTACLES ) ) {
+        // the step a background load lands on depends on timing, so
+        // recordings and replays load in place
+        if ( gw->record != NULL || gw->replay != NULL ) {
+            if ( !loadObstacleData( gw, OBSTACLES_FILE ) ) {
+                loadObstacleData( gw, OBSTACLES_TEXT_FILE );
+            }
+        } else {
+            startObstacleLoader( gw->obstacleLoader, OBSTACLES_FILE, OBSTACLES_TEXT_FILE );
+        }
     }
 
-    if ( IsKeyPressed( KEY_F7 ) ) {
+    if ( hasGameAction( input, GAME_ACTION_RESET_OBSTACLES ) ) {
         resetObstacles( gw );
     }
 
-    resolveParticlesObstaclesCollision( gw );
+    // emitters with fast particles take more and shorter passes, the
+    // obstacles were already edited so they are the same in all of them
+    int passes = updateEmitterSubsteps( gw, delta );
+
+    for ( int pass = 0; pass < passes; pass++ ) {
+
+        beginProfilerZone( PROFILER_ZONE_INTEGRATE );
+        integrateParticlesGameWorld( gw, delta, pass );
+        endProfilerZone( PROFILER_ZONE_INTEGRATE );
+
+        if ( pass == 0 && passes > 1 ) {
+            copyStepStartPositions( gw, false );
+        }
+
+        beginProfilerZone( PROFILER_ZONE_COLLISION );
+        resolveParticlesObstaclesCollision( gw, pass );
+        endProfilerZone( PROFILER_ZONE_COLLISION );
+
+    }
+
+    if ( passes > 1 ) {
+        copyStepStartPositions( gw, true );
+    }
+
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        settleParticles( &gw->emitters[k]->particles, delta );
+    }
+
+    beginProfilerZone( PROFILER_ZONE_COMPACT );
+    removeDeadParticlesGameWorld( gw, input->screenWidth, input->screenHeight );
+    endProfilerZone( PROFILER_ZONE_COMPACT );
 
-    if ( IsKeyPressed( KEY_UP ) ) {
-        currentZoom += 0.1f;
-    } else if ( IsKeyPressed( KEY_DOWN ) ) {
-        currentZoom -= 0.1f;
-        if ( currentZoom <= 0.0f ) {
-            currentZoom = 0.1f;
+    if ( hasGameAction( input, GAME_ACTION_ZOOM_IN ) ) {
+        gw->camera.zoom += 0.1f;
+    } else if ( hasGameAction( input, GAME_ACTION_ZOOM_OUT ) ) {
+        gw->camera.zoom -= 0.1f;
+        if ( gw->camera.zoom <= 0.0f ) {
+            gw->camera.zoom = 0.1f;
         }
     }
 
-    updateCamera( &gw->camera );
+    updateCamera( &gw->camera, input->screenWidth, input->screenHeight );
+
+    endStepProfiler();
 
 }
 
 /**
- * @brief Draws the state of the game.
+ * @brief Draws the state of the game captured in the snapshot, using the
+ * drawing side of the world.
  */
-void drawGameWorld( GameWorld *gw ) {
+void drawGameWorld( GameWorld *gw, RenderSnapshot *rs ) {
+
+    ParticleRenderer *pr = &gw->particleRenderer;
+
+    if ( !pr->initialized ) {
+        int maxParticles = 0;
+        for ( int i = 0; i < rs->emittersQuantity; i++ ) {
+            if ( rs->emitters[i].particles.capacity > maxParticles ) {
+                maxParticles = rs->emitters[i].particles.capacity;
+            }
+        }
+        *pr = createParticleRenderer( maxParticles );
+    }
+
+    double traceStart = beginTraceZone();
+    Rectangle view = getCameraView( rs->camera, GetScreenWidth(), GetScreenHeight() );
+    beginFrameParticleRenderer( pr, view, rs->camera.zoom );
+
+    // the snapshot holds the state at the end of the last step, which is
+    // drawn one step late to have the next positions to interpolate to
+    float alpha = (float) ( ( getTimePlatform() - rs->time ) / rs->fixedDelta );
+    alpha = alpha < 0.0f ? 0.0f : alpha > 1.0f ? 1.0f : alpha;
+
+    // render textures can't be drawn to between BeginDrawing and EndDrawing
+    beginProfilerZone( PROFILER_ZONE_OBSTACLE_DRAW );
+    drawObstacleLayer( gw, rs );
+    endProfilerZone( PROFILER_ZONE_OBSTACLE_DRAW );
 
     BeginDrawing();
     ClearBackground( BLACK );
 
-    BeginMode2D( gw->camera );
-
-    drawParticleEmitter( &gw->peMoveSin );
-    drawParticleEmitter( &gw->peMouseDown );
-    drawParticleEmitter( &gw->peStaticRight );
-    drawParticleEmitter( &gw->peStaticTop );
+    BeginMode2D( rs->camera );
 
-    for ( int i = 0; i < gw->obstacleQuantity; i++ ) {
-        drawObstacle( &gw->obstacles[i] );
+    beginProfilerZone( PROFILER_ZONE_PARTICLE_DRAW );
+    for ( int i = 0; i < rs->emittersQuantity; i++ ) {
+        drawParticleEmitter( &rs->emitters[i], pr, alpha );
     }
+    endProfilerZone( PROFILER_ZONE_PARTICLE_DRAW );
+
+    // render textures are upside down
+    beginProfilerZone( PROFILER_ZONE_OBSTACLE_DRAW );
+    DrawTexturePro( 
+        gw->obstacleLayer.texture, 
+        (Rectangle) { 0.0f, 0.0f, gw->obstacleLayer.texture.width, -gw->obstacleLayer.texture.height }, 
+        rs->obstacleView, 
+        (Vector2) { 0.0f, 0.0f }, 
+        0.0f, 
+        WHITE
+    );
+    endProfilerZone( PROFILER_ZONE_OBSTACLE_DRAW );
     
     if ( showInfo ) {
         DrawFPS( 20, 20 );
         int y = 20;
-        DrawText( TextFormat( "particles (moving): %d", gw->peMoveSin.particleQuantity ), 20, y += 20, 20, WHITE );
-        DrawText( TextFormat( "particles (mouse): %d", gw->peMouseDown.particleQuantity ), 20, y += 20, 20, WHITE );
-        DrawText( TextFormat( "particles (static left): %d", gw->peStaticRight.particleQuantity ), 20, y += 20, 20, WHITE );
-        DrawText( TextFormat( "particles (static right): %d", gw->peStaticTop.particleQuantity ), 20, y += 20, 20, WHITE );
-        DrawText( TextFormat( "obstacles: %d", gw->obstacleQuantity ), 20, (y += 20), 20, WHITE );
+        DrawText( TextFormat( "particles (moving): %d", rs->emitters[0].particles.quantity ), 20, y += 20, 20, WHITE );
+        DrawText( TextFormat( "particles (mouse): %d", rs->emitters[1].particles.quantity ), 20, y += 20, 20, WHITE );
+        DrawText( TextFormat( "particles (static left): %d", rs->emitters[2].particles.quantity ), 20, y += 20, 20, WHITE );
+        DrawText( TextFormat( "particles (static right): %d", rs->emitters[3].particles.quantity ), 20, y += 20, 20, WHITE );
+        if ( rs->useTileMap ) {
+            DrawText( TextFormat( "tiles: %d", rs->tileQuantity ), 20, (y += 20), 20, WHITE );
+        } else {
+            DrawText( TextFormat( "obstacles: %d (%d drawn)", rs->totalObstacles, rs->obstacleQuantity ), 20, (y += 20), 20, WHITE );
+        }
+        DrawText( TextFormat( "particles drawn: %d (%d vertices)", pr->drawnParticles, pr->drawnVertices ), 20, (y += 20), 20, WHITE );
+        DrawText( "<F2>: save profiler samples", 20, (y += 20), 20, WHITE );
+        DrawText( trace.active ? "<F3>: tracing..." : "<F3>: trace 300 frames", 20, (y += 20), 20, WHITE );
+        DrawText( rs->useTileMap ? "<F4>: use rectangles" : "<F4>: use tile map", 20, (y += 20), 20, WHITE );
         DrawText( "<F5>: save obstacles", 20, (y += 20), 20, WHITE );
-        DrawText( "<F6>: load obstacles", 20, (y += 20), 20, WHITE );
+        DrawText( rs->loadingObstacles ? "<F6>: loading obstacles..." : "<F6>: load obstacles", 20, (y += 20), 20, WHITE );
         DrawText( "<F7>: reset obstacles", 20, (y += 20), 20, WHITE );
+        DrawText( "<F8>: export obstacles as text", 20, (y += 20), 20, WHITE );
+        DrawText( "<F9>: save world", 20, (y += 20), 20, WHITE );
+        DrawText( "<F10>: load world", 20, (y += 20), 20, WHITE );
+        drawProfilerGameWorld( GetScreenWidth() - 300, 20 );
     }
 
     EndMode2D();
+
+    // includes the wait of the frame limiter
+    beginProfilerZone( PROFILER_ZONE_PRESENT );
     EndDrawing();
+    endProfilerZone( PROFILER_ZONE_PRESENT );
+
+    endTraceZone( "draw", traceStart );
+
+}
+
+/**
+ * @brief Draws a table with the rolling statistics of each profiler zone.
+ */
+void drawProfilerGameWorld( int x, int y ) {
+
+    DrawRectangle( x - 5, y - 5, 295, 20 + PROFILER_ZONE_COUNT * 15, Fade( BLACK, 0.7f ) );
+    DrawText( "ms", x, y, 10, WHITE );
+    DrawText( "mean", x + 100, y, 10, WHITE );
+    DrawText( "p50", x + 145, y, 10, WHITE );
+    DrawText( "p99", x + 190, y, 10, WHITE );
+    DrawText( "max", x + 235, y, 10, WHITE );
+
+    for ( int i = 0; i < PROFILER_ZONE_COUNT; i++ ) {
+        ProfilerStats stats = getStatsProfilerZone( (ProfilerZone) i );
+        y += 15;
+        DrawText( getNameProfilerZone( (ProfilerZone) i ), x, y, 10, WHITE );
+        DrawText( TextFormat( "%.3f", stats.mean * 1000.0 ), x + 100, y, 10, WHITE );
+        DrawText( TextFormat( "%.3f", stats.p50 * 1000.0 ), x + 145, y, 10, WHITE );
+        DrawText( TextFormat( "%.3f", stats.p99 * 1000.0 ), x + 190, y, 10, WHITE );
+        DrawText( TextFormat( "%.3f", stats.max * 1000.0 ), x + 235, y, 10, WHITE );
+    }
+
+}
+
+/**
+ * @brief Sets the simulation rate (steps per second) and how many steps
+ * a single frame may run before the remaining time is dropped.
+ */
+void setSimulationRateGameWorld( GameWorld *gw, float stepsPerSecond, int maxSubsteps ) {
+    gw->fixedDelta = 1.0f / stepsPerSecond;
+    gw->maxSubsteps = maxSubsteps < 1 ? 1 : maxSubsteps;
+}
+
+/**
+ * @brief Sets how many threads (the calling one included) update the
+ * particles. 0 uses every available processor.
+ */
+void setThreadQuantityGameWorld( GameWorld *gw, int threadQuantity ) {
+
+    if ( threadQuantity <= 0 ) {
+        threadQuantity = getProcessorCountPlatform();
+    }
+
+    if ( gw->workerPool != NULL ) {
+        destroyWorkerPool( gw->workerPool );
+    }
+
+    gw->workerPool = createWorkerPool( threadQuantity - 1 );
+
+}
+
+/**
+ * @brief Integrates the particles of the emitters that take the given
+ * substep pass, each one by its share of delta.
+ */
+void integrateParticlesGameWorld( GameWorld *gw, float delta, int pass ) {
+    ParticleJob job = { gw, delta };
+    updateParticleOffsets( gw, pass );
+    runWorkerPool( gw->workerPool, integrateParticlesTask, &job, gw->particleOffsets[gw->emittersQuantity], MIN_PARTICLES_PER_THREAD );
+}
+
+/**
+ * @brief Removes old particles and the ones that left the world. The world
+ * is what the camera shows plus the area covered by obstacles, with a
+ * margin.
+ */
+void removeDeadParticlesGameWorld( GameWorld *gw, int screenWidth, int screenHeight ) {
+
+    Vector2 topLeft = GetScreenToWorld2D( (Vector2) { 0.0f, 0.0f }, gw->camera );
+    Vector2 bottomRight = GetScreenToWorld2D( (Vector2) { screenWidth, screenHeight }, gw->camera );
+    ObstacleGrid *grid = &gw->obstacleGrid;
+    Rectangle obstacleBounds;
+    bool hasObstacles = false;
+
+    if ( gw->useTileMap ) {
+        hasObstacles = getBoundsTileMap( &gw->tileMap, &obstacleBounds );
+    } else if ( gw->obstacleQuantity > 0 && grid->columns > 0 ) {
+        obstacleBounds = (Rectangle) { grid->originX, grid->originY, grid->columns * grid->cellSize, grid->rows * grid->cellSize };
+        hasObstacles = true;
+    }
+
+    if ( hasObstacles ) {
+        topLeft.x = fminf( topLeft.x, obstacleBounds.x );
+        topLeft.y = fminf( topLeft.y, obstacleBounds.y );
+        bottomRight.x = fmaxf( bottomRight.x, obstacleBounds.x + obstacleBounds.width );
+        bottomRight.y = fmaxf( bottomRight.y, obstacleBounds.y + obstacleBounds.height );
+    }
+
+    Rectangle bounds = {
+        topLeft.x - WORLD_BOUNDS_MARGIN,
+        topLeft.y - WORLD_BOUNDS_MARGIN,
+        bottomRight.x - topLeft.x + WORLD_BOUNDS_MARGIN * 2,
+        bottomRight.y - topLeft.y + WORLD_BOUNDS_MARGIN * 2
+    };
+
+    gw->removedParticles = 0;
+
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        gw->removedParticles += compactParticles( &gw->emitters[k]->particles, bounds );
+    }
+
+}
+
+/**
+ * @brief Bumps obstacleLayerVersion if the obstacles or the view changed
+ * since the last call and returns it.
+ */
+unsigned int updateObstacleLayerGameWorld( GameWorld *gw ) {
+
+    Rectangle view = getCameraView( gw->camera, gw->pendingInput.screenWidth, gw->pendingInput.screenHeight );
+    Rectangle last = gw->obstacleLayerView;
+
+    if ( gw->obstacleLayerDirty || view.x != last.x || view.y != last.y || view.width != last.width || view.height != last.height ) {
+        gw->obstacleLayerVersion++;
+        gw->obstacleLayerView = view;
+        gw->obstacleLayerDirty = false;
+    }
+
+    return gw->obstacleLayerVersion;
+
+}
+
+/**
+ * @brief Writes the obstacles (or the runs of tiles) that touch view, up to
+ * capacity of them. Returns how many there are. The rectangles are found
+ * through the grid, visiting only the cells view covers.
+ */
+int getVisibleObstaclesGameWorld( GameWorld *gw, Rectangle view, Rectangle *rects, int capacity ) {
+
+    if ( gw->useTileMap ) {
+        return getViewRunsTileMap( &gw->tileMap, view, rects, capacity );
+    }
+
+    ObstacleGrid *grid = &gw->obstacleGrid;
+    int c0, r0, c1, r1;
+    int quantity = 0;
+
+    updateObstacleGrid( gw );
+
+    if ( gw->obstacleQuantity == 0 || !getCellRangeObstacleGrid( grid, view, &c0, &r0, &c1, &r1 ) ) {
+        return 0;
+    }
+
+    for ( int r = r0; r <= r1; r++ ) {
+        for ( int c = c0; c <= c1; c++ ) {
+
+            int cell = r * grid->columns + c;
+
+            for ( int e = grid->cellStart[cell]; e < grid->cellStart[cell + 1]; e++ ) {
+
+                int j = grid->entries[e];
+
+                // taken only in the first visible cell it touches
+                int fc = grid->firstColumn[j] > c0 ? grid->firstColumn[j] : c0;
+                int fr = grid->firstRow[j] > r0 ? grid->firstRow[j] : r0;
+
+                if ( fc == c && fr == r && CheckCollisionRecs( gw->obstacles[j].rect, view ) ) {
+                    if ( quantity < capacity ) {
+                        rects[quantity] = gw->obstacles[j].rect;
+                    }
+                    quantity++;
+                }
+
+            }
+
+        }
+    }
+
+    return quantity;
 
 }
 
 void createObstacleGameWorld( GameWorld *gw, float delta, Vector2 pos ) {
 
-    nextObstacleCounter += delta;
+    // painting tiles is idempotent, so there is no need to space them
+    if ( gw->useTileMap ) {
+        float size = gw->tileMap.tileSize > 20.0f ? gw->tileMap.tileSize : 20.0f;
+        Rectangle area = { pos.x - size / 2, pos.y - size / 2, size, size };
+        fillTileMap( &gw->tileMap, area );
+        wakeParticlesGameWorld( gw, &area );
+        gw->obstacleLayerDirty = true;
+        return;
+    }
+
+    gw->obstacleCounter += delta;
 
-    if ( nextObstacleCounter >= timeToNextObstacle ) {
+    if ( gw->obstacleCounter >= timeToNextObstacle ) {
 
-        nextObstacleCounter = 0;
+        gw->obstacleCounter = 0;
 
         int k = gw->newObstaclePos % gw->maxObstacles;
 
+        // the oldest obstacle is replaced when there is no room left
+        if ( k < gw->obstacleQuantity ) {
+            wakeParticlesGameWorld( gw, &gw->obstacles[k].rect );
+        }
+
         pos.x -= 10.0f;
         pos.y -= 10.0f;
 
@@ -260,164 +837,981 @@ void createObstacleGameWorld( GameWorld *gw, float delta, Vector2 pos ) {
             RAYWHITE
         );
 
+        wakeParticlesGameWorld( gw, &gw->obstacles[k].rect );
         gw->newObstaclePos++;
         
         if ( gw->obstacleQuantity < gw->maxObstacles ) {
             gw->obstacleQuantity++;
         }
 
+        gw->obstacleGridDirty = true;
+        gw->obstacleLayerDirty = true;
+
     }
 
 }
 
-void resolveParticlesObstaclesCollision( GameWorld *gw ) {
+/**
+ * @brief Resolves the collisions of the particles of the emitters that
+ * take the given substep pass.
+ */
+void resolveParticlesObstaclesCollision( GameWorld *gw, int pass ) {
 
-    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+    if ( gw->useTileMap ) {
+        if ( gw->tileMap.solidQuantity == 0 ) {
+            return;
+        }
+    } else {
+        updateObstacleGrid( gw );
+        if ( gw->obstacleQuantity == 0 ) {
+            return;
+        }
+    }
 
-        ParticleEmitter *pe = gw->emitters[k];
-        Particle *particles = pe->particles;
-
-        for ( int i = 0; i < pe->particleQuantity; i++ ) {
-
-            Particle *p = &particles[i];
-
-            for ( int j = 0; j < gw->obstacleQuantity; j++ ) {
-                Obstacle *o = &gw->obstacles[j];
-                if ( CheckCollisionCircleRec( p->pos, p->radius, o->topCP ) ) {
-                    p->vel.y = -200.f;
-                    p->vel.y *= p->elasticity;
-                } else if ( CheckCollisionCircleRec( p->pos, p->radius, o->bottomCP ) ) {
-                    p->pos.y = o->rect.y + o->rect.height + p->radius;
-                    p->vel.y *= p->elasticity;
-                } else if ( CheckCollisionCircleRec( p->pos, p->radius, o->leftCP ) ) {
-                    p->pos.x = o->rect.x - p->radius;
-                    p->vel.x = -fabs( p->vel.x );
-                    p->vel.x *= p->elasticity;
-                } else if ( CheckCollisionCircleRec( p->pos, p->radius, o->rightCP ) ) {
-                    p->pos.x = o->rect.x + o->rect.width + p->radius;
-                    p->vel.x = fabs( p->vel.x );
-                    p->vel.x *= p->elasticity;
-                }
-            }
+    ParticleJob job = { gw, 0.0f };
+    updateParticleOffsets( gw, pass );
+    runWorkerPool( gw->workerPool, resolveCollisionTask, &job, gw->particleOffsets[gw->emittersQuantity], MIN_PARTICLES_PER_THREAD );
 
-        }
+}
 
+/**
+ * @brief Recomputes where each emitter starts when the particles that take
+ * the given pass are seen as a single array, so jobs can be split
+ * regardless of emitters. Emitters with fewer substeps are left out.
+ */
+static void updateParticleOffsets( GameWorld *gw, int pass ) {
+    gw->particleOffsets[0] = 0;
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        int quantity = gw->emitterSubsteps[k] > pass ? gw->emitters[k]->particles.awake : 0;
+        gw->particleOffsets[k + 1] = gw->particleOffsets[k] + quantity;
     }
-
 }
 
-void saveObstacleData( GameWorld *gw, const char *fileName ) {
-    
-    FILE *file = fopen( fileName, "w" );
+/**
+ * @brief Chooses the substeps of each emitter from the distance its
+ * fastest particle will move in delta, so only the emitters with fast
+ * particles pay for more passes. Returns the most substeps taken.
+ */
+static int updateEmitterSubsteps( GameWorld *gw, float delta ) {
 
-    if ( file != NULL ) {
+    int passes = 1;
 
-        fprintf( file, "%d\n", gw->maxObstacles );
-        fprintf( file, "%d\n", gw->obstacleQuantity );
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
 
-        for ( int i = 0; i < gw->obstacleQuantity; i++ ) {
-            Obstacle *o = &gw->obstacles[i];
-            fprintf( file, "%.2f %.2f %.2f %.2f\n", o->rect.x, o->rect.y, o->rect.width, o->rect.height );
-        }
+        float displacement = getMaxSpeedParticles( &gw->emitters[k]->particles ) * delta;
+        int substeps = (int) ceilf( displacement / MAX_STEP_DISPLACEMENT );
 
-        fclose( file );
+        substeps = substeps < 1 ? 1 : substeps > MAX_PARTICLE_SUBSTEPS ? MAX_PARTICLE_SUBSTEPS : substeps;
+        gw->emitterSubsteps[k] = substeps;
 
-    }
+        if ( substeps > passes ) {
+            passes = substeps;
+        }
 
-}
+    }
 
-void loadObstacleData( GameWorld *gw, const char *fileName ) {
-    
-    FILE *file = fopen( fileName, "r" );
-    
-    if ( file != NULL ) {
+    return passes;
 
-        free( gw->obstacles );
+}
 
-        fscanf( file, "%d", &gw->maxObstacles );
-        fscanf( file, "%d", &gw->obstacleQuantity );
-        gw->newObstaclePos = 0;
-        gw->obstacles = (Obstacle*) malloc( gw->maxObstacles * sizeof( Obstacle ) );
+/**
+ * @brief Saves the previous positions of the particles of the substepped
+ * emitters after their first pass or, if restore is true, puts them back
+ * after the last one, so drawing interpolates over the whole step.
+ */
+static void copyStepStartPositions( GameWorld *gw, bool restore ) {
 
-        int k = 0;
+    int offset = 0;
 
-        while ( !feof( file ) ) {
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
 
-            float x;
-            float y;
-            float width;
-            float height;
+        ParticleStore *ps = &gw->emitters[k]->particles;
 
-            int read = fscanf( file, "%f %f %f %f", &x, &y, &width, &height );
-            gw->obstacles[k++] = createObstacle( (Vector2){ x, y }, (Vector2){ width, height }, RAYWHITE );
+        if ( gw->emitterSubsteps[k] < 2 ) {
+            continue;
+        }
 
-            if ( read != 4 ) {
-                break;
-            }
+        if ( !restore && offset + ps->awake > gw->stepStartCapacity ) {
+            gw->stepStartCapacity = ( offset + ps->awake ) * 2;
+            gw->stepStartX = (float*) realloc( gw->stepStartX, gw->stepStartCapacity * sizeof( float ) );
+            gw->stepStartY = (float*) realloc( gw->stepStartY, gw->stepStartCapacity * sizeof( float ) );
+        }
 
+        if ( restore ) {
+            memcpy( ps->prevX, gw->stepStartX + offset, ps->awake * sizeof( float ) );
+            memcpy( ps->prevY, gw->stepStartY + offset, ps->awake * sizeof( float ) );
+        } else {
+            memcpy( gw->stepStartX + offset, ps->prevX, ps->awake * sizeof( float ) );
+            memcpy( gw->stepStartY + offset, ps->prevY, ps->awake * sizeof( float ) );
         }
 
-        fclose( file );
+        offset += ps->awake;
 
     }
 
 }
 
-void resetObstacles( GameWorld *gw ) {
-    gw->newObstaclePos = 0;
-    gw->obstacleQuantity = 0;
+/**
+ * @brief Wakes the sleeping particles near area, or all of them if area
+ * is NULL, when the obstacles there change.
+ */
+static void wakeParticlesGameWorld( GameWorld *gw, const Rectangle *area ) {
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        wakeParticles( &gw->emitters[k]->particles, area );
+    }
 }
 
-void updateCamera( Camera2D *camera ) {
-
-    float hWidth = GetScreenWidth() / 2;
-    float hHeight = GetScreenHeight() / 2;
+static void integrateParticlesTask( void *context, int start, int end, int part ) {
 
-    camera->zoom = currentZoom;
+    ParticleJob *job = (ParticleJob*) context;
+    GameWorld *gw = job->gw;
+    double traceStart = beginTraceZone();
 
-    camera->target.x = hWidth;
-    camera->target.y = hHeight;
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        int s = ( start > gw->particleOffsets[k] ? start : gw->particleOffsets[k] ) - gw->particleOffsets[k];
+        int e = ( end < gw->particleOffsets[k + 1] ? end : gw->particleOffsets[k + 1] ) - gw->particleOffsets[k];
+        if ( s < e ) {
+            updateParticles( &gw->emitters[k]->particles, s, e, job->delta / gw->emitterSubsteps[k] );
+        }
+    }
 
-    camera->offset.x = hWidth + ( hWidth * ( camera->zoom - 1.0f ) ); 
-    camera->offset.y = hHeight + ( hHeight * ( camera->zoom - 1.0f ) );
+    endTraceZone( "integrate part", traceStart );
 
 }
 
-bool resolveParticleEmitterMouseOperations( ParticleEmitter *pe, Camera2D camera ) {
-
-    Vector2 mousePos = GetMousePosition();
-    Vector2 pePos = GetWorldToScreen2D( pe->pos, camera );
+static void resolveCollisionTask( void *context, int start, int end, int part ) {
 
-    static float xOffset;
-    static float yOffset;
+    ParticleJob *job = (ParticleJob*) context;
+    GameWorld *gw = job->gw;
+    double traceStart = beginTraceZone();
 
-    if ( pe->draggable && isMouseOverParticleEmitter( pePos, pe->radius * camera.zoom, mousePos ) ) {
-        pe->mouseOver = true;
-        if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
-            pe->dragging = true;
-            xOffset = pePos.x - mousePos.x;
-            yOffset = pePos.y - mousePos.y;
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+        int s = ( start > gw->particleOffsets[k] ? start : gw->particleOffsets[k] ) - gw->particleOffsets[k];
+        int e = ( end < gw->particleOffsets[k + 1] ? end : gw->particleOffsets[k + 1] ) - gw->particleOffsets[k];
+        if ( s < e ) {
+            if ( gw->useTileMap ) {
+                resolveParticleRangeTileCollision( gw, &gw->emitters[k]->particles, s, e );
+            } else {
+                resolveParticleRangeCollision( gw, &gw->emitters[k]->particles, s, e );
+            }
         }
-    } else {
-        pe->mouseOver = false;
     }
 
-    if ( IsMouseButtonReleased( MOUSE_BUTTON_LEFT ) ) {
-        pe->dragging = false;
-    }
+    endTraceZone( "collide part", traceStart );
 
-    if ( pe->dragging ) {
-        pe->mouseOver = true;
+}
+
+/**
+ * @brief Resolves the particles in batches of COLLISION_BATCH_SIZE. A
+ * batch belongs to the range that holds its first particle, so the batches
+ * (and the results) are the same however the particles are split among
+ * the threads.
+ */
+static void resolveParticleRangeCollision( GameWorld *gw, ParticleStore *ps, int start, int end ) {
+
+    int first = ( start + COLLISION_BATCH_SIZE - 1 ) / COLLISION_BATCH_SIZE * COLLISION_BATCH_SIZE;
+
+    for ( int i = first; i < end; i += COLLISION_BATCH_SIZE ) {
+        int count = ps->awake - i < COLLISION_BATCH_SIZE ? ps->awake - i : COLLISION_BATCH_SIZE;
+        resolveParticleBatchCollision( gw, ps, i, count );
+    }
+
+}
+
+/**
+ * @brief Gathers the obstacles near any particle of the batch and tests
+ * the whole batch against each one at once. Particles next to each other
+ * were usually emitted together, so they share most of their obstacles.
+ * Fast particles are swept against them first. Batches spread over too
+ * many obstacles are resolved one particle at a time.
+ */
+static void resolveParticleBatchCollision( GameWorld *gw, ParticleStore *ps, int start, int count ) {
+
+    ObstacleGrid *grid = &gw->obstacleGrid;
+    int candidates[COLLISION_BATCH_CANDIDATES];
+    int candidateQuantity = 0;
+    unsigned int fast = 0;
+
+    for ( int i = start; i < start + count && candidateQuantity >= 0; i++ ) {
+
+        // fast particles gather along their whole path, which also covers
+        // where the sweep may leave them
+        float radius = ps->radius[i];
+        Rectangle bounds = { ps->x[i] - radius, ps->y[i] - radius, radius * 2, radius * 2 };
+        int c0, r0, c1, r1;
+
+        if ( isFastParticle( ps, i, MAX_STEP_DISPLACEMENT ) ) {
+            fast |= 1u << ( i - start );
+            bounds = getSweptBounds( ps, i );
+        }
+
+        if ( !getCellRangeObstacleGrid( grid, bounds, &c0, &r0, &c1, &r1 ) ) {
+            continue;
+        }
+
+        for ( int r = r0; r <= r1 && candidateQuantity >= 0; r++ ) {
+            for ( int c = c0; c <= c1 && candidateQuantity >= 0; c++ ) {
+
+                int cell = r * grid->columns + c;
+
+                for ( int e = grid->cellStart[cell]; e < grid->cellStart[cell + 1]; e++ ) {
+
+                    int j = grid->entries[e];
+                    int fc = grid->firstColumn[j] > c0 ? grid->firstColumn[j] : c0;
+                    int fr = grid->firstRow[j] > r0 ? grid->firstRow[j] : r0;
+                    int k = 0;
+
+                    // already seen in another cell of this particle
+                    if ( fc != c || fr != r ) {
+                        continue;
+                    }
+
+                    while ( k < candidateQuantity && candidates[k] != j ) {
+                        k++;
+                    }
+
+                    if ( k < candidateQuantity ) {
+                        continue;
+                    }
+
+                    if ( candidateQuantity == COLLISION_BATCH_CANDIDATES ) {
+                        candidateQuantity = -1;
+                        break;
+                    }
+
+                    candidates[candidateQuantity++] = j;
+
+                }
+
+            }
+        }
+
+    }
+
+    if ( candidateQuantity < 0 ) {
+        for ( int i = start; i < start + count; i++ ) {
+            if ( fast & ( 1u << ( i - start ) ) ) {
+                sweepParticleCollision( gw, ps, i );
+            }
+            resolveParticleCollision( gw, ps, i );
+        }
+        return;
+    }
+
+    for ( int i = 0; fast != 0; i++, fast >>= 1 ) {
+        if ( fast & 1 ) {
+            ParticleSweep sweep = { .time = INFINITY, .face = CONTACT_FACE_NONE };
+            Rectangle bounds = getSweptBounds( ps, start + i );
+            for ( int k = 0; k < candidateQuantity; k++ ) {
+                Rectangle rect = gw->obstacles[candidates[k]].rect;
+                if ( CheckCollisionRecs( bounds, rect ) ) {
+                    sweepParticleRectangle( ps, start + i, rect, CONTACT_FACE_ALL, &sweep );
+                }
+            }
+            applyParticleSweep( ps, start + i, &sweep );
+        }
+    }
+
+    for ( int k = 0; k < candidateQuantity; k++ ) {
+
+        Obstacle *o = &gw->obstacles[candidates[k]];
+
+        // the positions are read again for each obstacle, since the
+        // responses move the particles
+        unsigned int hits = testRectangleCollisionBatch( ps->x + start, ps->y + start, ps->radius + start, count, o->rect );
+
+        for ( int i = 0; hits != 0; i++, hits >>= 1 ) {
+            if ( hits & 1 ) {
+                resolveParticleObstacleCollision( ps, start + i, o );
+            }
+        }
+
+    }
+
+}
+
+static void resolveParticleCollision( GameWorld *gw, ParticleStore *ps, int i ) {
+
+    ObstacleGrid *grid = &gw->obstacleGrid;
+    float radius = ps->radius[i];
+    Rectangle bounds = { ps->x[i] - radius, ps->y[i] - radius, radius * 2, radius * 2 };
+    int c0, r0, c1, r1;
+
+    if ( !getCellRangeObstacleGrid( grid, bounds, &c0, &r0, &c1, &r1 ) ) {
+        return;
+    }
+
+    for ( int r = r0; r <= r1; r++ ) {
+        for ( int c = c0; c <= c1; c++ ) {
+
+            int cell = r * grid->columns + c;
+
+            for ( int e = grid->cellStart[cell]; e < grid->cellStart[cell + 1]; e++ ) {
+
+                int j = grid->entries[e];
+
+                // an obstacle that spans several of the visited cells
+                // is only resolved in the first one they share
+                int fc = grid->firstColumn[j] > c0 ? grid->firstColumn[j] : c0;
+                int fr = grid->firstRow[j] > r0 ? grid->firstRow[j] : r0;
+
+                if ( fc == c && fr == r ) {
+                    resolveParticleObstacleCollision( ps, i, &gw->obstacles[j] );
+                }
+
+            }
+
+        }
+    }
+
+}
+
+static void resolveParticleObstacleCollision( ParticleStore *ps, int i, Obstacle *o ) {
+    resolveParticleContact( ps, i, o->rect, CONTACT_FACE_ALL );
+}
+
+/**
+ * @brief Saves the obstacles in the binary format (see ObstacleFile.h).
+ */
+void saveObstacleData( GameWorld *gw, const char *fileName ) {
+
+    if ( gw->useTileMap ) {
+        copyTilesToObstacles( gw );
+    }
+
+    saveObstacleFile( fileName, gw->obstacles, gw->obstacleQuantity, gw->maxObstacles );
+
+}
+
+/**
+ * @brief Saves the obstacles as text, one rectangle per line.
+ */
+void exportObstacleData( GameWorld *gw, const char *fileName ) {
+
+    if ( gw->useTileMap ) {
+        copyTilesToObstacles( gw );
+    }
+    
+    FILE *file = fopen( fileName, "w" );
+
+    if ( file != NULL ) {
+
+        fprintf( file, "%d\n", gw->maxObstacles );
+        fprintf( file, "%d\n", gw->obstacleQuantity );
+
+        for ( int i = 0; i < gw->obstacleQuantity; i++ ) {
+            Obstacle *o = &gw->obstacles[i];
+            fprintf( file, "%.2f %.2f %.2f %.2f\n", o->rect.x, o->rect.y, o->rect.width, o->rect.height );
+        }
+
+        fclose( file );
+
+    }
+
+}
+
+/**
+ * @brief Loads a binary obstacle file, or a text one if the file doesn't
+ * start like a binary file, and swaps it in right away. Returns false,
+ * with the obstacles untouched, if the file couldn't be loaded.
+ */
+bool loadObstacleData( GameWorld *gw, const char *fileName ) {
+
+    ObstacleSet set = createObstacleSet( OBSTACLE_GRID_CELL_SIZE );
+
+    if ( !loadObstacleSet( &set, fileName ) ) {
+        destroyObstacleSet( &set );
+        return false;
+    }
+
+    swapObstacleSetGameWorld( gw, &set );
+
+    return true;
+
+}
+
+/**
+ * @brief Replaces the obstacles and their grid by the ones of set, which
+ * gets the old ones and is destroyed. Only pointers move, so the cost
+ * doesn't depend on the size of the set (apart from the tile map, which is
+ * rasterized again in tile mode).
+ */
+void swapObstacleSetGameWorld( GameWorld *gw, ObstacleSet *set ) {
+
+    ObstacleSet old = {
+        .maxObstacles = gw->maxObstacles,
+        .obstacleQuantity = gw->obstacleQuantity,
+        .obstacles = gw->obstacles,
+        .grid = gw->obstacleGrid
+    };
+
+    gw->maxObstacles = set->maxObstacles;
+    gw->obstacleQuantity = set->obstacleQuantity;
+    gw->obstacles = set->obstacles;
+    gw->obstacleGrid = set->grid;
+    gw->newObstaclePos = gw->obstacleQuantity;
+    gw->obstacleGridDirty = false;
+    gw->obstacleLayerDirty = true;
+
+    *set = old;
+    destroyObstacleSet( set );
+    wakeParticlesGameWorld( gw, NULL );
+
+    if ( gw->useTileMap ) {
+        rasterizeObstaclesTileMap( &gw->tileMap, gw->obstacles, gw->obstacleQuantity );
+    }
+
+}
+
+void resetObstacles( GameWorld *gw ) {
+    gw->newObstaclePos = 0;
+    gw->obstacleQuantity = 0;
+    gw->obstacleGridDirty = true;
+    gw->obstacleLayerDirty = true;
+    if ( gw->useTileMap ) {
+        clearTileMap( &gw->tileMap );
+    }
+    wakeParticlesGameWorld( gw, NULL );
+}
+
+/**
+ * @brief Replaces the obstacles by the fewest non overlapping rectangles
+ * that cover the same area the greedy merge finds, if they are fewer.
+ * Painting leaves lots of overlapping squares behind and each one costs
+ * collision tests and a draw call.
+ */
+void optimizeObstacles( GameWorld *gw ) {
+
+    int quantity = mergeObstacles( gw->obstacles, gw->obstacleQuantity );
+
+    if ( quantity != gw->obstacleQuantity ) {
+        gw->obstacleQuantity = quantity;
+        gw->newObstaclePos = quantity;
+        gw->obstacleGridDirty = true;
+        gw->obstacleLayerDirty = true;
+    }
+
+}
+
+/**
+ * @brief Moves the obstacles to a tile map of tileSize tiles, or back to
+ * free rectangles (one per run of tiles) if tileSize is 0.
+ */
+void setTileMapGameWorld( GameWorld *gw, float tileSize ) {
+
+    gw->obstacleLayerDirty = true;
+
+    // the tiles don't cover exactly what the rectangles did
+    wakeParticlesGameWorld( gw, NULL );
+
+    if ( gw->useTileMap ) {
+        copyTilesToObstacles( gw );
+        destroyTileMap( &gw->tileMap );
+        gw->useTileMap = false;
+    }
+
+    if ( tileSize <= 0.0f ) {
+        return;
+    }
+
+    // centered on what the camera looks at
+    gw->tileSize = tileSize;
+    gw->tileMap = createTileMap( 
+        tileSize,
+        gw->camera.target.x - TILE_MAP_WIDTH / 2,
+        gw->camera.target.y - TILE_MAP_HEIGHT / 2,
+        (int) ceilf( TILE_MAP_WIDTH / tileSize ),
+        (int) ceilf( TILE_MAP_HEIGHT / tileSize )
+    );
+    rasterizeObstaclesTileMap( &gw->tileMap, gw->obstacles, gw->obstacleQuantity );
+    gw->useTileMap = true;
+
+}
+
+void updateCamera( Camera2D *camera, int screenWidth, int screenHeight ) {
+
+    float hWidth = screenWidth / 2;
+    float hHeight = screenHeight / 2;
+
+    camera->target.x = hWidth;
+    camera->target.y = hHeight;
+
+    camera->offset.x = hWidth + ( hWidth * ( camera->zoom - 1.0f ) ); 
+    camera->offset.y = hHeight + ( hHeight * ( camera->zoom - 1.0f ) );
+
+}
+
+/**
+ * @brief The part of the world the camera shows on a screen of the given
+ * size.
+ */
+Rectangle getCameraView( Camera2D camera, int screenWidth, int screenHeight ) {
+    Vector2 topLeft = GetScreenToWorld2D( (Vector2) { 0.0f, 0.0f }, camera );
+    Vector2 bottomRight = GetScreenToWorld2D( (Vector2) { screenWidth, screenHeight }, camera );
+    return (Rectangle) { topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y };
+}
+
+bool resolveParticleEmitterMouseOperations( ParticleEmitter *pe, Camera2D camera, const GameInput *input ) {
+
+    Vector2 mousePos = input->mousePos;
+    Vector2 pePos = GetWorldToScreen2D( pe->pos, camera );
+
+    static float xOffset;
+    static float yOffset;
+
+    if ( pe->draggable && isMouseOverParticleEmitter( pePos, pe->radius * camera.zoom, mousePos ) ) {
+        pe->mouseOver = true;
+        if ( input->mouseLeftPressed ) {
+            pe->dragging = true;
+            xOffset = pePos.x - mousePos.x;
+            yOffset = pePos.y - mousePos.y;
+        }
+    } else {
+        pe->mouseOver = false;
+    }
+
+    if ( input->mouseLeftReleased ) {
+        pe->dragging = false;
+    }
+
+    if ( pe->dragging ) {
+        pe->mouseOver = true;
         mousePos.x += xOffset;
         mousePos.y += yOffset;
         pe->pos = GetScreenToWorld2D( mousePos, camera );
     }
 
     if ( pe->mouseOver ) {
-        float m = GetMouseWheelMove() * 2;
+        float m = input->mouseWheelMove * 2;
         pe->launchAngle += m;
     }
 
     return pe->dragging;
 
+}
+
+static void resolveParticleRangeTileCollision( GameWorld *gw, ParticleStore *ps, int start, int end ) {
+
+    TileMap *tm = &gw->tileMap;
+    float tileSize = tm->tileSize;
+    float extent = tileSize < MAX_STEP_DISPLACEMENT ? tileSize : MAX_STEP_DISPLACEMENT;
+
+    for ( int i = start; i < end; i++ ) {
+
+        if ( isFastParticle( ps, i, extent ) ) {
+            sweepParticleTileCollision( gw, ps, i );
+        }
+
+        float radius = ps->radius[i];
+        int c0 = (int) floorf( ( ps->x[i] - radius - tm->originX ) / tileSize );
+        int r0 = (int) floorf( ( ps->y[i] - radius - tm->originY ) / tileSize );
+        int c1 = (int) floorf( ( ps->x[i] + radius - tm->originX ) / tileSize );
+        int r1 = (int) floorf( ( ps->y[i] + radius - tm->originY ) / tileSize );
+
+        for ( int r = r0; r <= r1; r++ ) {
+            for ( int c = c0; c <= c1; c++ ) {
+                if ( isSolidTileMap( tm, c, r ) ) {
+                    resolveParticleTileCollision( ps, i, tm, c, r );
+                }
+            }
+        }
+
+    }
+
+}
+
+/**
+ * @brief Faces shared with another solid tile are inside a wall and are
+ * never hit, so tiles in a row behave as one block.
+ */
+static void resolveParticleTileCollision( ParticleStore *ps, int i, TileMap *tm, int column, int row ) {
+
+    Rectangle rect = {
+        tm->originX + column * tm->tileSize,
+        tm->originY + row * tm->tileSize,
+        tm->tileSize,
+        tm->tileSize
+    };
+
+    resolveParticleContact( ps, i, rect, getOpenFacesTile( tm, column, row ) );
+
+}
+
+/**
+ * @brief The faces of a tile that aren't shared with another solid tile.
+ */
+static unsigned int getOpenFacesTile( TileMap *tm, int column, int row ) {
+
+    unsigned int faces = CONTACT_FACE_NONE;
+
+    if ( !isSolidTileMap( tm, column, row - 1 ) ) {
+        faces |= CONTACT_FACE_TOP;
+    }
+    if ( !isSolidTileMap( tm, column, row + 1 ) ) {
+        faces |= CONTACT_FACE_BOTTOM;
+    }
+    if ( !isSolidTileMap( tm, column - 1, row ) ) {
+        faces |= CONTACT_FACE_LEFT;
+    }
+    if ( !isSolidTileMap( tm, column + 1, row ) ) {
+        faces |= CONTACT_FACE_RIGHT;
+    }
+
+    return faces;
+
+}
+
+/**
+ * @brief Resolves the contact between a particle and a rectangle in a
+ * single pass: the closest point of the rectangle to the center tells if
+ * they touch, and the contact normal is the face, among the given ones,
+ * the particle went the least into.
+ */
+static void resolveParticleContact( ParticleStore *ps, int i, Rectangle rect, unsigned int faces ) {
+
+    float radius = ps->radius[i];
+    float x = ps->x[i];
+    float y = ps->y[i];
+
+    float left = rect.x;
+    float top = rect.y;
+    float right = rect.x + rect.width;
+    float bottom = rect.y + rect.height;
+
+    float dx = x - fminf( fmaxf( x, left ), right );
+    float dy = y - fminf( fmaxf( y, top ), bottom );
+
+    if ( dx * dx + dy * dy > radius * radius ) {
+        return;
+    }
+
+    ContactFace face = CONTACT_FACE_NONE;
+    float depth = INFINITY;
+
+    if ( ( faces & CONTACT_FACE_TOP ) && y + radius - top < depth ) {
+        face = CONTACT_FACE_TOP;
+        depth = y + radius - top;
+    }
+    if ( ( faces & CONTACT_FACE_BOTTOM ) && bottom - ( y - radius ) < depth ) {
+        face = CONTACT_FACE_BOTTOM;
+        depth = bottom - ( y - radius );
+    }
+    if ( ( faces & CONTACT_FACE_LEFT ) && x + radius - left < depth ) {
+        face = CONTACT_FACE_LEFT;
+        depth = x + radius - left;
+    }
+    if ( ( faces & CONTACT_FACE_RIGHT ) && right - ( x - radius ) < depth ) {
+        face = CONTACT_FACE_RIGHT;
+        depth = right - ( x - radius );
+    }
+
+    applyContactResponse( ps, i, rect, face );
+
+}
+
+/**
+ * @brief A particle that hits a top face is thrown up, the other faces
+ * push it out and damp the velocity along the normal.
+ */
+static void applyContactResponse( ParticleStore *ps, int i, Rectangle rect, ContactFace face ) {
+
+    float radius = ps->radius[i];
+    float elasticity = ps->elasticity;
+
+    if ( face == CONTACT_FACE_TOP ) {
+        // a particle that keeps landing on the same spot would bounce
+        // there forever, it is brought to rest and falls asleep instead
+        if ( updateRestParticle( ps, i ) ) {
+            ps->vx[i] = 0.0f;
+            ps->vy[i] = 0.0f;
+        } else {
+            ps->vy[i] = -200.f;
+            ps->vy[i] *= elasticity;
+        }
+    } else if ( face == CONTACT_FACE_BOTTOM ) {
+        ps->y[i] = rect.y + rect.height + radius;
+        ps->vy[i] *= elasticity;
+    } else if ( face == CONTACT_FACE_LEFT ) {
+        ps->x[i] = rect.x - radius;
+        ps->vx[i] = -fabs( ps->vx[i] );
+        ps->vx[i] *= elasticity;
+    } else if ( face == CONTACT_FACE_RIGHT ) {
+        ps->x[i] = rect.x + rect.width + radius;
+        ps->vx[i] = fabs( ps->vx[i] );
+        ps->vx[i] *= elasticity;
+    }
+
+}
+
+/**
+ * @brief Returns true if the particle moved more than its diameter plus
+ * extent in the last pass: far enough to go through an obstacle extent
+ * wide without touching it before or after the move.
+ */
+static bool isFastParticle( ParticleStore *ps, int i, float extent ) {
+    float dx = ps->x[i] - ps->prevX[i];
+    float dy = ps->y[i] - ps->prevY[i];
+    float reach = ps->radius[i] * 2 + extent;
+    return dx * dx + dy * dy > reach * reach;
+}
+
+/**
+ * @brief The area the particle swept in the last step.
+ */
+static Rectangle getSweptBounds( ParticleStore *ps, int i ) {
+    float radius = ps->radius[i];
+    float x0 = fminf( ps->prevX[i], ps->x[i] );
+    float y0 = fminf( ps->prevY[i], ps->y[i] );
+    return (Rectangle) {
+        x0 - radius,
+        y0 - radius,
+        fmaxf( ps->prevX[i], ps->x[i] ) - x0 + radius * 2,
+        fmaxf( ps->prevY[i], ps->y[i] ) - y0 + radius * 2
+    };
+}
+
+/**
+ * @brief Sweeps the path of the particle in the last step against rect
+ * grown by its radius (the corners are treated as square). If the path
+ * enters it through one of the given faces and sooner than sweep->time,
+ * records the hit in sweep. Paths that start inside are left to the
+ * discrete test.
+ */
+static void sweepParticleRectangle( ParticleStore *ps, int i, Rectangle rect, unsigned int faces, ParticleSweep *sweep ) {
+
+    float radius = ps->radius[i];
+    float x0 = ps->prevX[i];
+    float y0 = ps->prevY[i];
+    float dx = ps->x[i] - x0;
+    float dy = ps->y[i] - y0;
+
+    float left = rect.x - radius;
+    float top = rect.y - radius;
+    float right = rect.x + rect.width + radius;
+    float bottom = rect.y + rect.height + radius;
+
+    if ( x0 > left && x0 < right && y0 > top && y0 < bottom ) {
+        return;
+    }
+
+    float enterX = -INFINITY;
+    float exitX = INFINITY;
+    float enterY = -INFINITY;
+    float exitY = INFINITY;
+
+    if ( dx != 0.0f ) {
+        float t0 = ( left - x0 ) / dx;
+        float t1 = ( right - x0 ) / dx;
+        enterX = fminf( t0, t1 );
+        exitX = fmaxf( t0, t1 );
+    } else if ( x0 < left || x0 > right ) {
+        return;
+    }
+
+    if ( dy != 0.0f ) {
+        float t0 = ( top - y0 ) / dy;
+        float t1 = ( bottom - y0 ) / dy;
+        enterY = fminf( t0, t1 );
+        exitY = fmaxf( t0, t1 );
+    } else if ( y0 < top || y0 > bottom ) {
+        return;
+    }
+
+    float enter = fmaxf( enterX, enterY );
+    float exit = fminf( exitX, exitY );
+
+    if ( enter > exit || enter < 0.0f || enter > 1.0f || enter >= sweep->time ) {
+        return;
+    }
+
+    ContactFace face;
+
+    if ( enterX > enterY ) {
+        face = dx > 0.0f ? CONTACT_FACE_LEFT : CONTACT_FACE_RIGHT;
+    } else {
+        face = dy > 0.0f ? CONTACT_FACE_TOP : CONTACT_FACE_BOTTOM;
+    }
+
+    if ( faces & face ) {
+        sweep->time = enter;
+        sweep->face = face;
+        sweep->rect = rect;
+    }
+
+}
+
+/**
+ * @brief Moves a particle with a recorded hit back along its path to the
+ * first contact and applies the response of the face it hit there.
+ */
+static void applyParticleSweep( ParticleStore *ps, int i, ParticleSweep *sweep ) {
+
+    if ( sweep->face == CONTACT_FACE_NONE ) {
+        return;
+    }
+
+    ps->x[i] = ps->prevX[i] + ( ps->x[i] - ps->prevX[i] ) * sweep->time;
+    ps->y[i] = ps->prevY[i] + ( ps->y[i] - ps->prevY[i] ) * sweep->time;
+    applyContactResponse( ps, i, sweep->rect, sweep->face );
+
+}
+
+/**
+ * @brief Continuous collision of a fast particle against the obstacles
+ * along its path, so a long step can't take it through one.
+ */
+static void sweepParticleCollision( GameWorld *gw, ParticleStore *ps, int i ) {
+
+    ObstacleGrid *grid = &gw->obstacleGrid;
+    ParticleSweep sweep = { .time = INFINITY, .face = CONTACT_FACE_NONE };
+    int c0, r0, c1, r1;
+
+    if ( !getCellRangeObstacleGrid( grid, getSweptBounds( ps, i ), &c0, &r0, &c1, &r1 ) ) {
+        return;
+    }
+
+    for ( int r = r0; r <= r1; r++ ) {
+        for ( int c = c0; c <= c1; c++ ) {
+
+            int cell = r * grid->columns + c;
+
+            for ( int e = grid->cellStart[cell]; e < grid->cellStart[cell + 1]; e++ ) {
+
+                int j = grid->entries[e];
+                int fc = grid->firstColumn[j] > c0 ? grid->firstColumn[j] : c0;
+                int fr = grid->firstRow[j] > r0 ? grid->firstRow[j] : r0;
+
+                if ( fc == c && fr == r ) {
+                    sweepParticleRectangle( ps, i, gw->obstacles[j].rect, CONTACT_FACE_ALL, &sweep );
+                }
+
+            }
+
+        }
+    }
+
+    applyParticleSweep( ps, i, &sweep );
+
+}
+
+/**
+ * @brief Continuous collision of a fast particle against the solid tiles
+ * along its path, through the faces not shared with another solid tile.
+ */
+static void sweepParticleTileCollision( GameWorld *gw, ParticleStore *ps, int i ) {
+
+    TileMap *tm = &gw->tileMap;
+    float tileSize = tm->tileSize;
+    Rectangle bounds = getSweptBounds( ps, i );
+    ParticleSweep sweep = { .time = INFINITY, .face = CONTACT_FACE_NONE };
+
+    int c0 = (int) floorf( ( bounds.x - tm->originX ) / tileSize );
+    int r0 = (int) floorf( ( bounds.y - tm->originY ) / tileSize );
+    int c1 = (int) floorf( ( bounds.x + bounds.width - tm->originX ) / tileSize );
+    int r1 = (int) floorf( ( bounds.y + bounds.height - tm->originY ) / tileSize );
+
+    c0 = c0 > tm->firstColumn ? c0 : tm->firstColumn;
+    r0 = r0 > tm->firstRow ? r0 : tm->firstRow;
+    c1 = c1 < tm->lastColumn ? c1 : tm->lastColumn;
+    r1 = r1 < tm->lastRow ? r1 : tm->lastRow;
+
+    for ( int r = r0; r <= r1; r++ ) {
+        for ( int c = c0; c <= c1; c++ ) {
+            if ( isSolidTileMap( tm, c, r ) ) {
+                Rectangle rect = { tm->originX + c * tileSize, tm->originY + r * tileSize, tileSize, tileSize };
+                sweepParticleRectangle( ps, i, rect, getOpenFacesTile( tm, c, r ), &sweep );
+            }
+        }
+    }
+
+    applyParticleSweep( ps, i, &sweep );
+
+}
+
+/**
+ * @brief Replaces the obstacles by the runs of solid tiles.
+ */
+static void copyTilesToObstacles( GameWorld *gw ) {
+
+    TileMap *tm = &gw->tileMap;
+    int quantity = getRunsTileMap( tm, NULL, 0 );
+
+    if ( quantity > gw->maxObstacles ) {
+        gw->maxObstacles = quantity;
+        gw->obstacles = (Obstacle*) realloc( gw->obstacles, gw->maxObstacles * sizeof( Obstacle ) );
+    }
+
+    Rectangle *runs = (Rectangle*) malloc( ( quantity > 0 ? quantity : 1 ) * sizeof( Rectangle ) );
+    getRunsTileMap( tm, runs, quantity );
+
+    for ( int i = 0; i < quantity; i++ ) {
+        gw->obstacles[i] = createObstacle( 
+            (Vector2) { runs[i].x, runs[i].y },
+            (Vector2) { runs[i].width, runs[i].height },
+            RAYWHITE
+        );
+    }
+
+    free( runs );
+
+    gw->obstacleQuantity = quantity;
+    gw->newObstaclePos = quantity;
+    gw->obstacleGridDirty = true;
+
+}
+
+/**
+ * @brief Rebuilds the obstacle grid if the obstacles changed since the
+ * last build.
+ */
+static void updateObstacleGrid( GameWorld *gw ) {
+    if ( gw->obstacleGridDirty ) {
+        buildObstacleGrid( &gw->obstacleGrid, gw->obstacles, gw->obstacleQuantity );
+        gw->obstacleGridDirty = false;
+    }
+}
+
+/**
+ * @brief Draws the obstacles of the snapshot into the layer if they
+ * aren't the ones already there or if the screen size changed.
+ */
+static void drawObstacleLayer( GameWorld *gw, RenderSnapshot *rs ) {
+
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+
+    if ( gw->obstacleLayer.texture.width != width || gw->obstacleLayer.texture.height != height ) {
+        if ( gw->obstacleLayer.id != 0 ) {
+            UnloadRenderTexture( gw->obstacleLayer );
+        }
+        gw->obstacleLayer = LoadRenderTexture( width, height );
+        gw->drawnObstacleLayerVersion = rs->obstacleVersion - 1;
+    }
+
+    if ( gw->drawnObstacleLayerVersion == rs->obstacleVersion ) {
+        return;
+    }
+
+    // the layer covers obstacleView, which the composition maps back to it
+    Camera2D camera = {
+        .target = { rs->obstacleView.x, rs->obstacleView.y },
+        .offset = { 0.0f, 0.0f },
+        .rotation = 0.0f,
+        .zoom = rs->obstacleView.width > 0.0f ? width / rs->obstacleView.width : 1.0f
+    };
+
+    BeginTextureMode( gw->obstacleLayer );
+    ClearBackground( BLANK );
+    BeginMode2D( camera );
+
+    // every obstacle is created RAYWHITE
+    for ( int i = 0; i < rs->obstacleQuantity; i++ ) {
+        DrawRectangleRec( rs->obstacles[i], RAYWHITE );
+    }
+
+    EndMode2D();
+    EndTextureMode();
+
+    gw->drawnObstacleLayerVersion = rs->obstacleVersion;
+
 }
\ No newline at end of file
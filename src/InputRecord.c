@@ -0,0 +1,220 @@
+/**
+ * @file InputRecord.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Input recording implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "InputRecord.h"
+#include "GameInput.h"
+#include "raylib/raylib.h"
+
+struct InputRecord {
+
+    FILE *file;
+    bool writing;
+    InputRecordHeader header;
+
+    // input of the previous step, only the fields that differ from it are
+    // stored
+    GameInput last;
+    int steps;
+
+};
+
+static unsigned char packButtons( const GameInput *input );
+
+InputRecord *createInputRecord( const char *fileName, InputRecordHeader header ) {
+
+    FILE *file = fopen( fileName, "wb" );
+
+    if ( file == NULL ) {
+        return NULL;
+    }
+
+    header.magic = INPUT_RECORD_MAGIC;
+    header.version = INPUT_RECORD_VERSION;
+    header.stepQuantity = 0;
+    header.reserved = 0;
+
+    if ( fwrite( &header, sizeof( header ), 1, file ) != 1 ) {
+        fclose( file );
+        return NULL;
+    }
+
+    InputRecord *record = (InputRecord*) calloc( 1, sizeof( InputRecord ) );
+    record->file = file;
+    record->writing = true;
+    record->header = header;
+
+    return record;
+
+}
+
+InputRecord *openInputRecord( const char *fileName ) {
+
+    FILE *file = fopen( fileName, "rb" );
+    InputRecordHeader header;
+
+    if ( file == NULL ) {
+        return NULL;
+    }
+
+    if ( fread( &header, sizeof( header ), 1, file ) != 1 ||
+         header.magic != INPUT_RECORD_MAGIC ||
+         header.version != INPUT_RECORD_VERSION ) {
+        fclose( file );
+        return NULL;
+    }
+
+    InputRecord *record = (InputRecord*) calloc( 1, sizeof( InputRecord ) );
+    record->file = file;
+    record->writing = false;
+    record->header = header;
+
+    return record;
+
+}
+
+void closeInputRecord( InputRecord *record ) {
+
+    if ( record == NULL ) {
+        return;
+    }
+
+    if ( record->writing ) {
+        record->header.stepQuantity = record->steps;
+        if ( fseek( record->file, 0, SEEK_SET ) == 0 ) {
+            fwrite( &record->header, sizeof( record->header ), 1, record->file );
+        }
+    }
+
+    fclose( record->file );
+    free( record );
+
+}
+
+InputRecordHeader getHeaderInputRecord( InputRecord *record ) {
+    return record->header;
+}
+
+void writeInputRecord( InputRecord *record, const GameInput *input ) {
+
+    const GameInput *last = &record->last;
+    unsigned char buttons = packButtons( input );
+    unsigned char fields = 0;
+
+    if ( record->steps == 0 || input->delta != last->delta ) {
+        fields |= INPUT_RECORD_DELTA;
+    }
+    if ( record->steps == 0 || input->screenWidth != last->screenWidth || input->screenHeight != last->screenHeight ) {
+        fields |= INPUT_RECORD_SCREEN;
+    }
+    if ( record->steps == 0 || input->mousePos.x != last->mousePos.x || input->mousePos.y != last->mousePos.y ) {
+        fields |= INPUT_RECORD_MOUSE;
+    }
+    if ( input->mouseWheelMove != 0.0f ) {
+        fields |= INPUT_RECORD_WHEEL;
+    }
+    if ( buttons != packButtons( last ) ) {
+        fields |= INPUT_RECORD_BUTTONS;
+    }
+    if ( input->actions != 0 ) {
+        fields |= INPUT_RECORD_ACTIONS;
+    }
+
+    FILE *file = record->file;
+    int32_t screen[2] = { input->screenWidth, input->screenHeight };
+    uint32_t actions = input->actions;
+
+    fwrite( &fields, 1, 1, file );
+
+    if ( fields & INPUT_RECORD_DELTA ) {
+        fwrite( &input->delta, sizeof( float ), 1, file );
+    }
+    if ( fields & INPUT_RECORD_SCREEN ) {
+        fwrite( screen, sizeof( int32_t ), 2, file );
+    }
+    if ( fields & INPUT_RECORD_MOUSE ) {
+        fwrite( &input->mousePos.x, sizeof( float ), 1, file );
+        fwrite( &input->mousePos.y, sizeof( float ), 1, file );
+    }
+    if ( fields & INPUT_RECORD_WHEEL ) {
+        fwrite( &input->mouseWheelMove, sizeof( float ), 1, file );
+    }
+    if ( fields & INPUT_RECORD_BUTTONS ) {
+        fwrite( &buttons, 1, 1, file );
+    }
+    if ( fields & INPUT_RECORD_ACTIONS ) {
+        fwrite( &actions, sizeof( uint32_t ), 1, file );
+    }
+
+    record->last = *input;
+    record->steps++;
+
+}
+
+bool readInputRecord( InputRecord *record, GameInput *input ) {
+
+    FILE *file = record->file;
+    GameInput next = record->last;
+    unsigned char fields;
+    bool ok = fread( &fields, 1, 1, file ) == 1;
+
+    // events only last for the step that stored them
+    next.mouseWheelMove = 0.0f;
+    next.actions = 0;
+
+    if ( ok && ( fields & INPUT_RECORD_DELTA ) ) {
+        ok = fread( &next.delta, sizeof( float ), 1, file ) == 1;
+    }
+    if ( ok && ( fields & INPUT_RECORD_SCREEN ) ) {
+        int32_t screen[2];
+        ok = fread( screen, sizeof( int32_t ), 2, file ) == 2;
+        next.screenWidth = screen[0];
+        next.screenHeight = screen[1];
+    }
+    if ( ok && ( fields & INPUT_RECORD_MOUSE ) ) {
+        ok = fread( &next.mousePos.x, sizeof( float ), 1, file ) == 1 &&
+             fread( &next.mousePos.y, sizeof( float ), 1, file ) == 1;
+    }
+    if ( ok && ( fields & INPUT_RECORD_WHEEL ) ) {
+        ok = fread( &next.mouseWheelMove, sizeof( float ), 1, file ) == 1;
+    }
+    if ( ok && ( fields & INPUT_RECORD_BUTTONS ) ) {
+        unsigned char buttons;
+        ok = fread( &buttons, 1, 1, file ) == 1;
+        next.mouseLeftDown = ( buttons & 1 ) != 0;
+        next.mouseLeftPressed = ( buttons & 2 ) != 0;
+        next.mouseLeftReleased = ( buttons & 4 ) != 0;
+        next.mouseRightDown = ( buttons & 8 ) != 0;
+    }
+    if ( ok && ( fields & INPUT_RECORD_ACTIONS ) ) {
+        uint32_t actions;
+        ok = fread( &actions, sizeof( uint32_t ), 1, file ) == 1;
+        next.actions = actions;
+    }
+
+    if ( !ok ) {
+        return false;
+    }
+
+    record->last = next;
+    record->steps++;
+    *input = next;
+
+    return true;
+
+}
+
+static unsigned char packButtons( const GameInput *input ) {
+    return ( input->mouseLeftDown ? 1 : 0 ) |
+           ( input->mouseLeftPressed ? 2 : 0 ) |
+           ( input->mouseLeftReleased ? 4 : 0 ) |
+           ( input->mouseRightDown ? 8 : 0 );
+}
\ No newline at end of file
@@ -1,11 +1,19 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
 #include "Obstacle.h"
 #include "raylib/raylib.h"
 
-Obstacle createObstacle( Vector2 pos, Vector2 dim, Color color ) {
+// above this many cells in the compressed grid the rectangles aren't merged
+#define MERGE_MAX_CELLS ( 1 << 24 )
 
-    float marginP = 0.1f;
-    float thicknessP = 0.3f; 
+static Rectangle *mergeRectanglesGreedy( const Rectangle *rects, int quantity, int *mergedQuantity );
+static int sortEdges( float *edges, int quantity );
+static int findEdge( const float *edges, int quantity, float value );
+static int compareEdges( const void *a, const void *b );
 
+Obstacle createObstacle( Vector2 pos, Vector2 dim, Color color ) {
     return (Obstacle) {
         .rect = {
             .x = pos.x,
@@ -13,38 +21,246 @@ Obstacle createObstacle( Vector2 pos, Vector2 dim, Color color ) {
             .width = dim.x,
             .height = dim.y
         },
-        .topCP = {
-            .x = pos.x + dim.x * marginP,
-            .y = pos.y,
-            .width = dim.x * ( 1.0f - marginP * 2 ),
-            .height = dim.y * thicknessP
-        },
-        .bottomCP = {
-            .x = pos.x + dim.x * marginP,
-            .y = pos.y + dim.y - dim.y * thicknessP,
-            .width = dim.x * ( 1.0f - marginP * 2 ),
-            .height = dim.y * thicknessP
-        },
-        .leftCP = {
-            .x = pos.x,
-            .y = pos.y + dim.y * marginP,
-            .width = dim.x * thicknessP,
-            .height = dim.y * ( 1.0f - marginP * 2 )
-        },
-        .rightCP = {
-            .x = pos.x + dim.x - dim.x * thicknessP,
-            .y = pos.y + dim.y * marginP,
-            .width = dim.x * thicknessP,
-            .height = dim.y * ( 1.0f - marginP * 2 )
-        },
         .color = color
     };
 }
 
 void drawObstacle( Obstacle *obstacle ) {
     DrawRectangleRec( obstacle->rect, obstacle->color );
-    /*DrawRectangleRec( obstacle->topCP, GREEN );
-    DrawRectangleRec( obstacle->bottomCP, RED );
-    DrawRectangleRec( obstacle->leftCP, BLUE );
-    DrawRectangleRec( obstacle->rightCP, YELLOW );*/
+}
+
+/**
+ * @brief Covers the union of the rectangles with non overlapping
+ * rectangles, using as few as the greedy approach finds: it is run both
+ * growing rows first and columns first and the smaller result is kept.
+ * Returns a new array (to be freed) with mergedQuantity rectangles.
+ */
+Rectangle *mergeRectangles( const Rectangle *rects, int quantity, int *mergedQuantity ) {
+
+    Rectangle *transposed = (Rectangle*) malloc( ( quantity > 0 ? quantity : 1 ) * sizeof( Rectangle ) );
+    for ( int i = 0; i < quantity; i++ ) {
+        transposed[i] = (Rectangle) { rects[i].y, rects[i].x, rects[i].height, rects[i].width };
+    }
+
+    int rowQuantity;
+    int columnQuantity;
+    Rectangle *byRows = mergeRectanglesGreedy( rects, quantity, &rowQuantity );
+    Rectangle *byColumns = mergeRectanglesGreedy( transposed, quantity, &columnQuantity );
+    free( transposed );
+
+    if ( rowQuantity <= columnQuantity ) {
+        free( byColumns );
+        *mergedQuantity = rowQuantity;
+        return byRows;
+    }
+
+    for ( int i = 0; i < columnQuantity; i++ ) {
+        Rectangle r = byColumns[i];
+        byColumns[i] = (Rectangle) { r.y, r.x, r.height, r.width };
+    }
+
+    free( byRows );
+    *mergedQuantity = columnQuantity;
+
+    return byColumns;
+
+}
+
+/**
+ * @brief Replaces the obstacles, in place, by the merged rectangles of
+ * mergeRectangles if they are fewer. Strokes that aren't straight can
+ * need more non overlapping pieces than squares. Returns the new quantity.
+ */
+int mergeObstacles( Obstacle *obstacles, int quantity ) {
+
+    Rectangle *rects = (Rectangle*) malloc( ( quantity > 0 ? quantity : 1 ) * sizeof( Rectangle ) );
+
+    for ( int i = 0; i < quantity; i++ ) {
+        rects[i] = obstacles[i].rect;
+    }
+
+    int mergedQuantity;
+    Rectangle *merged = mergeRectangles( rects, quantity, &mergedQuantity );
+
+    if ( mergedQuantity < quantity ) {
+        for ( int i = 0; i < mergedQuantity; i++ ) {
+            obstacles[i] = createObstacle( 
+                (Vector2) { merged[i].x, merged[i].y },
+                (Vector2) { merged[i].width, merged[i].height },
+                obstacles[i].color
+            );
+        }
+        quantity = mergedQuantity;
+    }
+
+    free( merged );
+    free( rects );
+
+    return quantity;
+
+}
+
+/**
+ * @brief The edges of the rectangles split the plane in a compressed grid
+ * of cells. Each covered cell is swept from the top left, growing a
+ * rectangle as wide and then as tall as the covered cells allow.
+ */
+static Rectangle *mergeRectanglesGreedy( const Rectangle *rects, int quantity, int *mergedQuantity ) {
+
+    float *xs = (float*) malloc( ( quantity * 2 + 1 ) * sizeof( float ) );
+    float *ys = (float*) malloc( ( quantity * 2 + 1 ) * sizeof( float ) );
+
+    for ( int i = 0; i < quantity; i++ ) {
+        xs[i * 2] = rects[i].x;
+        xs[i * 2 + 1] = rects[i].x + rects[i].width;
+        ys[i * 2] = rects[i].y;
+        ys[i * 2 + 1] = rects[i].y + rects[i].height;
+    }
+
+    int nx = sortEdges( xs, quantity * 2 );
+    int ny = sortEdges( ys, quantity * 2 );
+    long long cellQuantity = (long long) nx * ny;
+
+    Rectangle *merged = NULL;
+    *mergedQuantity = 0;
+
+    if ( quantity == 0 || cellQuantity > MERGE_MAX_CELLS ) {
+        merged = (Rectangle*) malloc( ( quantity > 0 ? quantity : 1 ) * sizeof( Rectangle ) );
+        memcpy( merged, rects, quantity * sizeof( Rectangle ) );
+        *mergedQuantity = quantity;
+        free( xs );
+        free( ys );
+        return merged;
+    }
+
+    // 2D difference array: after the prefix sums cover[y * nx + x] is how
+    // many rectangles cover the cell between edges x, x + 1, y and y + 1
+    int *cover = (int*) calloc( cellQuantity, sizeof( int ) );
+
+    for ( int i = 0; i < quantity; i++ ) {
+        int x0 = findEdge( xs, nx, rects[i].x );
+        int x1 = findEdge( xs, nx, rects[i].x + rects[i].width );
+        int y0 = findEdge( ys, ny, rects[i].y );
+        int y1 = findEdge( ys, ny, rects[i].y + rects[i].height );
+        cover[y0 * nx + x0]++;
+        cover[y0 * nx + x1]--;
+        cover[y1 * nx + x0]--;
+        cover[y1 * nx + x1]++;
+    }
+
+    for ( int y = 0; y < ny; y++ ) {
+        for ( int x = 0; x < nx; x++ ) {
+            int sum = cover[y * nx + x];
+            if ( x > 0 ) {
+                sum += cover[y * nx + x - 1];
+            }
+            if ( y > 0 ) {
+                sum += cover[( y - 1 ) * nx + x];
+            }
+            if ( x > 0 && y > 0 ) {
+                sum -= cover[( y - 1 ) * nx + x - 1];
+            }
+            cover[y * nx + x] = sum;
+        }
+    }
+
+    int capacity = quantity;
+    merged = (Rectangle*) malloc( capacity * sizeof( Rectangle ) );
+
+    // cells already used by a merged rectangle are set to zero
+    for ( int y = 0; y < ny - 1; y++ ) {
+        for ( int x = 0; x < nx - 1; x++ ) {
+
+            if ( cover[y * nx + x] <= 0 ) {
+                continue;
+            }
+
+            int x1 = x;
+            while ( x1 + 1 < nx - 1 && cover[y * nx + x1 + 1] > 0 ) {
+                x1++;
+            }
+
+            int y1 = y;
+            bool grow = true;
+            while ( grow && y1 + 1 < ny - 1 ) {
+                for ( int k = x; k <= x1; k++ ) {
+                    if ( cover[( y1 + 1 ) * nx + k] <= 0 ) {
+                        grow = false;
+                        break;
+                    }
+                }
+                if ( grow ) {
+                    y1++;
+                }
+            }
+
+            for ( int j = y; j <= y1; j++ ) {
+                memset( &cover[j * nx + x], 0, ( x1 - x + 1 ) * sizeof( int ) );
+            }
+
+            if ( *mergedQuantity == capacity ) {
+                capacity *= 2;
+                merged = (Rectangle*) realloc( merged, capacity * sizeof( Rectangle ) );
+            }
+
+            merged[( *mergedQuantity )++] = (Rectangle) {
+                xs[x], ys[y], xs[x1 + 1] - xs[x], ys[y1 + 1] - ys[y]
+            };
+
+        }
+    }
+
+    free( cover );
+    free( xs );
+    free( ys );
+
+    return merged;
+
+}
+
+/**
+ * @brief Sorts the edges and removes the repeated ones. Returns how many
+ * are left.
+ */
+static int sortEdges( float *edges, int quantity ) {
+
+    if ( quantity == 0 ) {
+        return 0;
+    }
+
+    qsort( edges, quantity, sizeof( float ), compareEdges );
+
+    int unique = 1;
+    for ( int i = 1; i < quantity; i++ ) {
+        if ( edges[i] != edges[unique - 1] ) {
+            edges[unique++] = edges[i];
+        }
+    }
+
+    return unique;
+
+}
+
+static int findEdge( const float *edges, int quantity, float value ) {
+
+    int low = 0;
+    int high = quantity - 1;
+
+    while ( low < high ) {
+        int middle = ( low + high ) / 2;
+        if ( edges[middle] < value ) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+
+}
+
+static int compareEdges( const void *a, const void *b ) {
+    float x = *(const float*) a;
+    float y = *(const float*) b;
+    return ( x > y ) - ( x < y );
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+ * @file ObstacleFile.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Binary obstacle file implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "ObstacleFile.h"
+#include "Obstacle.h"
+#include "Platform.h"
+#include "raylib/raylib.h"
+
+static uint32_t hashBytes( uint32_t hash, const void *data, size_t size );
+static uint32_t hashObstacleFile( const ObstacleFileHeader *header, const Rectangle *rects );
+
+bool saveObstacleFile( const char *fileName, const Obstacle *obstacles, int obstacleQuantity, int maxObstacles ) {
+
+    FILE *file = fopen( fileName, "wb" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    Rectangle *rects = (Rectangle*) malloc( ( obstacleQuantity > 0 ? obstacleQuantity : 1 ) * sizeof( Rectangle ) );
+    Rectangle bounds = { 0 };
+
+    for ( int i = 0; i < obstacleQuantity; i++ ) {
+
+        Rectangle r = obstacles[i].rect;
+        rects[i] = r;
+
+        if ( i == 0 ) {
+            bounds = r;
+        } else {
+            float x1 = fmaxf( bounds.x + bounds.width, r.x + r.width );
+            float y1 = fmaxf( bounds.y + bounds.height, r.y + r.height );
+            bounds.x = fminf( bounds.x, r.x );
+            bounds.y = fminf( bounds.y, r.y );
+            bounds.width = x1 - bounds.x;
+            bounds.height = y1 - bounds.y;
+        }
+
+    }
+
+    ObstacleFileHeader header = {
+        .magic = OBSTACLE_FILE_MAGIC,
+        .version = OBSTACLE_FILE_VERSION,
+        .maxObstacles = maxObstacles,
+        .obstacleQuantity = obstacleQuantity,
+        .bounds = bounds,
+        .checksum = 0,
+        .reserved = 0
+    };
+
+    header.checksum = hashObstacleFile( &header, rects );
+
+    bool ok = fwrite( &header, sizeof( header ), 1, file ) == 1 &&
+              (int) fwrite( rects, sizeof( Rectangle ), obstacleQuantity, file ) == obstacleQuantity;
+
+    free( rects );
+    ok = fclose( file ) == 0 && ok;
+
+    return ok;
+
+}
+
+bool openObstacleFile( ObstacleFile *of, const char *fileName ) {
+
+    memset( of, 0, sizeof( ObstacleFile ) );
+
+    long long size;
+    const void *data = mapFilePlatform( fileName, &size );
+
+    if ( data == NULL ) {
+        return false;
+    }
+
+    const ObstacleFileHeader *header = (const ObstacleFileHeader*) data;
+    const Rectangle *rects = (const Rectangle*) ( header + 1 );
+
+    bool valid = size >= (long long) sizeof( ObstacleFileHeader ) &&
+                 header->magic == OBSTACLE_FILE_MAGIC &&
+                 header->version == OBSTACLE_FILE_VERSION &&
+                 header->obstacleQuantity >= 0 &&
+                 header->maxObstacles >= header->obstacleQuantity &&
+                 header->maxObstacles <= MAX_OBSTACLES &&
+                 size == (long long) ( sizeof( ObstacleFileHeader ) + (size_t) header->obstacleQuantity * sizeof( Rectangle ) ) &&
+                 header->checksum == hashObstacleFile( header, rects );
+
+    if ( !valid ) {
+        unmapFilePlatform( data, size );
+        return false;
+    }
+
+    of->data = data;
+    of->size = size;
+    of->header = header;
+    of->rects = rects;
+
+    return true;
+
+}
+
+void closeObstacleFile( ObstacleFile *of ) {
+    unmapFilePlatform( of->data, of->size );
+    memset( of, 0, sizeof( ObstacleFile ) );
+}
+
+bool isBinaryObstacleFile( const char *fileName ) {
+
+    FILE *file = fopen( fileName, "rb" );
+    uint32_t magic = 0;
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    bool read = fread( &magic, sizeof( magic ), 1, file ) == 1;
+    fclose( file );
+
+    return read && magic == OBSTACLE_FILE_MAGIC;
+
+}
+
+/**
+ * @brief FNV-1a.
+ */
+static uint32_t hashBytes( uint32_t hash, const void *data, size_t size ) {
+    const unsigned char *bytes = (const unsigned char*) data;
+    for ( size_t i = 0; i < size; i++ ) {
+        hash = ( hash ^ bytes[i] ) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash of the header, without its checksum, and of the rectangles,
+ * so a damaged count can't pass as valid.
+ */
+static uint32_t hashObstacleFile( const ObstacleFileHeader *header, const Rectangle *rects ) {
+
+    ObstacleFileHeader h = *header;
+    h.checksum = 0;
+
+    uint32_t hash = hashBytes( 2166136261u, &h, sizeof( h ) );
+    return hashBytes( hash, rects, (size_t) header->obstacleQuantity * sizeof( Rectangle ) );
+
+}
\ No newline at end of file
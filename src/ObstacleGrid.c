@@ -0,0 +1,154 @@
+/**
+ * @file ObstacleGrid.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ObstacleGrid implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "ObstacleGrid.h"
+#include "Obstacle.h"
+#include "raylib/raylib.h"
+
+#define OBSTACLE_GRID_MAX_CELLS ( 1 << 20 )
+
+static void ensureCapacity( int **array, int *capacity, int required );
+
+ObstacleGrid createObstacleGrid( float cellSize ) {
+    return (ObstacleGrid) {
+        .preferredCellSize = cellSize,
+        .cellSize = cellSize
+    };
+}
+
+void destroyObstacleGrid( ObstacleGrid *grid ) {
+    free( grid->cellStart );
+    free( grid->entries );
+    free( grid->firstColumn );
+    free( grid->firstRow );
+    *grid = createObstacleGrid( grid->preferredCellSize );
+}
+
+void buildObstacleGrid( ObstacleGrid *grid, Obstacle *obstacles, int obstacleQuantity ) {
+
+    grid->columns = 0;
+    grid->rows = 0;
+    grid->entryQuantity = 0;
+
+    if ( obstacleQuantity <= 0 ) {
+        return;
+    }
+
+    float minX = obstacles[0].rect.x;
+    float minY = obstacles[0].rect.y;
+    float maxX = minX + obstacles[0].rect.width;
+    float maxY = minY + obstacles[0].rect.height;
+
+    for ( int i = 1; i < obstacleQuantity; i++ ) {
+        Rectangle r = obstacles[i].rect;
+        minX = fminf( minX, r.x );
+        minY = fminf( minY, r.y );
+        maxX = fmaxf( maxX, r.x + r.width );
+        maxY = fmaxf( maxY, r.y + r.height );
+    }
+
+    // the preferred cell size is kept unless the grid would be too big
+    float cellSize = grid->preferredCellSize;
+    int columns = (int) ( ( maxX - minX ) / cellSize ) + 1;
+    int rows = (int) ( ( maxY - minY ) / cellSize ) + 1;
+
+    while ( (long long) columns * rows > OBSTACLE_GRID_MAX_CELLS ) {
+        cellSize *= 2.0f;
+        columns = (int) ( ( maxX - minX ) / cellSize ) + 1;
+        rows = (int) ( ( maxY - minY ) / cellSize ) + 1;
+    }
+
+    grid->cellSize = cellSize;
+    grid->originX = minX;
+    grid->originY = minY;
+    grid->columns = columns;
+    grid->rows = rows;
+
+    int cellQuantity = columns * rows;
+    ensureCapacity( &grid->cellStart, &grid->cellCapacity, cellQuantity + 1 );
+    memset( grid->cellStart, 0, ( cellQuantity + 1 ) * sizeof( int ) );
+
+    if ( grid->obstacleCapacity < obstacleQuantity ) {
+        free( grid->firstColumn );
+        free( grid->firstRow );
+        grid->obstacleCapacity = obstacleQuantity * 2;
+        grid->firstColumn = (int*) malloc( grid->obstacleCapacity * sizeof( int ) );
+        grid->firstRow = (int*) malloc( grid->obstacleCapacity * sizeof( int ) );
+    }
+
+    // counts how many obstacles touch each cell...
+    int entryQuantity = 0;
+    for ( int i = 0; i < obstacleQuantity; i++ ) {
+        int c0, r0, c1, r1;
+        getCellRangeObstacleGrid( grid, obstacles[i].rect, &c0, &r0, &c1, &r1 );
+        grid->firstColumn[i] = c0;
+        grid->firstRow[i] = r0;
+        for ( int r = r0; r <= r1; r++ ) {
+            for ( int c = c0; c <= c1; c++ ) {
+                grid->cellStart[r * columns + c]++;
+            }
+        }
+        entryQuantity += ( r1 - r0 + 1 ) * ( c1 - c0 + 1 );
+    }
+
+    // ...turns the counts into the end offset of each cell...
+    for ( int i = 1; i <= cellQuantity; i++ ) {
+        grid->cellStart[i] += grid->cellStart[i - 1];
+    }
+
+    ensureCapacity( &grid->entries, &grid->entryCapacity, entryQuantity );
+    grid->entryQuantity = entryQuantity;
+
+    // ...and fills the cells backwards, so each offset ends at the cell start
+    for ( int i = obstacleQuantity - 1; i >= 0; i-- ) {
+        int c0, r0, c1, r1;
+        getCellRangeObstacleGrid( grid, obstacles[i].rect, &c0, &r0, &c1, &r1 );
+        for ( int r = r0; r <= r1; r++ ) {
+            for ( int c = c0; c <= c1; c++ ) {
+                grid->entries[--grid->cellStart[r * columns + c]] = i;
+            }
+        }
+    }
+
+}
+
+bool getCellRangeObstacleGrid( ObstacleGrid *grid, Rectangle rect, int *firstColumn, int *firstRow, int *lastColumn, int *lastRow ) {
+
+    if ( grid->columns == 0 ) {
+        return false;
+    }
+
+    int c0 = (int) floorf( ( rect.x - grid->originX ) / grid->cellSize );
+    int r0 = (int) floorf( ( rect.y - grid->originY ) / grid->cellSize );
+    int c1 = (int) floorf( ( rect.x + rect.width - grid->originX ) / grid->cellSize );
+    int r1 = (int) floorf( ( rect.y + rect.height - grid->originY ) / grid->cellSize );
+
+    if ( c1 < 0 || r1 < 0 || c0 >= grid->columns || r0 >= grid->rows ) {
+        return false;
+    }
+
+    *firstColumn = c0 < 0 ? 0 : c0;
+    *firstRow = r0 < 0 ? 0 : r0;
+    *lastColumn = c1 >= grid->columns ? grid->columns - 1 : c1;
+    *lastRow = r1 >= grid->rows ? grid->rows - 1 : r1;
+
+    return true;
+
+}
+
+static void ensureCapacity( int **array, int *capacity, int required ) {
+    if ( *capacity < required ) {
+        free( *array );
+        *capacity = required * 2;
+        *array = (int*) malloc( *capacity * sizeof( int ) );
+    }
+}
\ No newline at end of file
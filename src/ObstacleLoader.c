@@ -0,0 +1,122 @@
+/**
+ * @file ObstacleLoader.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ObstacleLoader implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ObstacleLoader.h"
+#include "ObstacleSet.h"
+
+#define OBSTACLE_LOADER_MAX_PATH 1024
+
+struct ObstacleLoader {
+
+    float cellSize;
+    pthread_t thread;
+
+    // set by the caller, read by the thread
+    char fileName[OBSTACLE_LOADER_MAX_PATH];
+    char fallbackFileName[OBSTACLE_LOADER_MAX_PATH];
+
+    // running goes true on start and back to false on take; finished is
+    // published by the thread once set and loaded are final
+    bool running;
+    int finished;
+    bool loaded;
+    ObstacleSet set;
+
+};
+
+static void *runLoader( void *arg );
+static void joinLoader( ObstacleLoader *loader );
+
+ObstacleLoader *createObstacleLoader( float cellSize ) {
+    ObstacleLoader *loader = (ObstacleLoader*) calloc( 1, sizeof( ObstacleLoader ) );
+    loader->cellSize = cellSize;
+    return loader;
+}
+
+void destroyObstacleLoader( ObstacleLoader *loader ) {
+
+    if ( loader->running ) {
+        joinLoader( loader );
+        destroyObstacleSet( &loader->set );
+    }
+
+    free( loader );
+
+}
+
+bool startObstacleLoader( ObstacleLoader *loader, const char *fileName, const char *fallbackFileName ) {
+
+    if ( loader->running ) {
+        return false;
+    }
+
+    strncpy( loader->fileName, fileName, OBSTACLE_LOADER_MAX_PATH - 1 );
+    strncpy( loader->fallbackFileName, fallbackFileName != NULL ? fallbackFileName : "", OBSTACLE_LOADER_MAX_PATH - 1 );
+    loader->loaded = false;
+    loader->set = createObstacleSet( loader->cellSize );
+    __atomic_store_n( &loader->finished, 0, __ATOMIC_RELAXED );
+
+    if ( pthread_create( &loader->thread, NULL, runLoader, loader ) != 0 ) {
+        destroyObstacleSet( &loader->set );
+        return false;
+    }
+
+    loader->running = true;
+
+    return true;
+
+}
+
+bool isBusyObstacleLoader( ObstacleLoader *loader ) {
+    return loader->running;
+}
+
+bool takeObstacleLoader( ObstacleLoader *loader, ObstacleSet *set ) {
+
+    if ( !loader->running || !__atomic_load_n( &loader->finished, __ATOMIC_ACQUIRE ) ) {
+        return false;
+    }
+
+    joinLoader( loader );
+
+    if ( !loader->loaded ) {
+        destroyObstacleSet( &loader->set );
+        return false;
+    }
+
+    *set = loader->set;
+    memset( &loader->set, 0, sizeof( ObstacleSet ) );
+
+    return true;
+
+}
+
+static void *runLoader( void *arg ) {
+
+    ObstacleLoader *loader = (ObstacleLoader*) arg;
+
+    loader->loaded = loadObstacleSet( &loader->set, loader->fileName );
+
+    if ( !loader->loaded && loader->fallbackFileName[0] != '\0' ) {
+        loader->loaded = loadObstacleSet( &loader->set, loader->fallbackFileName );
+    }
+
+    __atomic_store_n( &loader->finished, 1, __ATOMIC_RELEASE );
+
+    return NULL;
+
+}
+
+static void joinLoader( ObstacleLoader *loader ) {
+    pthread_join( loader->thread, NULL );
+    loader->running = false;
+}
\ No newline at end of file
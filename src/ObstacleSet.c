@@ -0,0 +1,151 @@
+/**
+ * @file ObstacleSet.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ObstacleSet implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ObstacleSet.h"
+#include "Obstacle.h"
+#include "ObstacleFile.h"
+#include "ObstacleGrid.h"
+#include "raylib/raylib.h"
+
+static bool loadBinary( ObstacleSet *set, const char *fileName );
+static bool loadText( ObstacleSet *set, const char *fileName );
+static bool setMaxObstacles( ObstacleSet *set, int maxObstacles );
+
+ObstacleSet createObstacleSet( float cellSize ) {
+    return (ObstacleSet) {
+        .maxObstacles = 0,
+        .obstacleQuantity = 0,
+        .obstacles = NULL,
+        .grid = createObstacleGrid( cellSize )
+    };
+}
+
+void destroyObstacleSet( ObstacleSet *set ) {
+    free( set->obstacles );
+    destroyObstacleGrid( &set->grid );
+    set->obstacles = NULL;
+    set->maxObstacles = 0;
+    set->obstacleQuantity = 0;
+}
+
+bool loadObstacleSet( ObstacleSet *set, const char *fileName ) {
+
+    bool loaded = isBinaryObstacleFile( fileName ) ? loadBinary( set, fileName ) : loadText( set, fileName );
+
+    if ( loaded ) {
+        buildObstacleGrid( &set->grid, set->obstacles, set->obstacleQuantity );
+    }
+
+    return loaded;
+
+}
+
+/**
+ * @brief The obstacles are built straight from the mapped rectangles.
+ */
+static bool loadBinary( ObstacleSet *set, const char *fileName ) {
+
+    ObstacleFile of;
+
+    if ( !openObstacleFile( &of, fileName ) ) {
+        return false;
+    }
+
+    if ( !setMaxObstacles( set, of.header->maxObstacles ) ) {
+        closeObstacleFile( &of );
+        return false;
+    }
+
+    const Rectangle *rects = of.rects;
+    int quantity = of.header->obstacleQuantity;
+
+    for ( int i = 0; i < quantity; i++ ) {
+        set->obstacles[i] = createObstacle( 
+            (Vector2) { rects[i].x, rects[i].y },
+            (Vector2) { rects[i].width, rects[i].height },
+            RAYWHITE
+        );
+    }
+
+    closeObstacleFile( &of );
+
+    set->obstacleQuantity = quantity;
+
+    return true;
+
+}
+
+static bool loadText( ObstacleSet *set, const char *fileName ) {
+    
+    FILE *file = fopen( fileName, "r" );
+    
+    if ( file == NULL ) {
+        return false;
+    }
+
+    int maxObstacles;
+    int quantity;
+
+    if ( fscanf( file, "%d %d", &maxObstacles, &quantity ) != 2 || maxObstacles < quantity || quantity < 0 ||
+         maxObstacles > MAX_OBSTACLES || !setMaxObstacles( set, maxObstacles ) ) {
+        fclose( file );
+        return false;
+    }
+
+    int k = 0;
+
+    while ( k < quantity ) {
+
+        float x;
+        float y;
+        float width;
+        float height;
+
+        if ( fscanf( file, "%f %f %f %f", &x, &y, &width, &height ) != 4 ) {
+            break;
+        }
+
+        set->obstacles[k++] = createObstacle( (Vector2){ x, y }, (Vector2){ width, height }, RAYWHITE );
+
+    }
+
+    fclose( file );
+
+    set->obstacleQuantity = mergeObstacles( set->obstacles, k );
+
+    return true;
+
+}
+
+/**
+ * @brief Resizes the obstacle array, keeping the obstacles that fit.
+ * Returns false, with the set untouched, if there is no memory for it.
+ */
+static bool setMaxObstacles( ObstacleSet *set, int maxObstacles ) {
+
+    maxObstacles = maxObstacles > 0 ? maxObstacles : 1;
+
+    if ( maxObstacles != set->maxObstacles ) {
+        Obstacle *obstacles = (Obstacle*) realloc( set->obstacles, (size_t) maxObstacles * sizeof( Obstacle ) );
+        if ( obstacles == NULL ) {
+            return false;
+        }
+        set->obstacles = obstacles;
+        set->maxObstacles = maxObstacles;
+        if ( set->obstacleQuantity > maxObstacles ) {
+            set->obstacleQuantity = maxObstacles;
+        }
+    }
+
+    return true;
+
+}
\ No newline at end of file
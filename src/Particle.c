@@ -1,36 +1,406 @@
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
 #include "Particle.h"
 #include "GameWorld.h"
+#include "utils.h"
 #include "raylib/raylib.h"
 
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define PARTICLE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define PARTICLE_ALIGNMENT 64
+
 static const float MAX_FALL_SPEED = 500.0f;
 
-Particle createParticle( Vector2 pos, Vector2 vel, float radius, Color color ) {
+// friction and gravity were tuned to be applied once per 60 Hz frame
+static const float REFERENCE_RATE = 60.0f;
+
+static const float DEFAULT_LIFETIME = 20.0f;
+
+// a particle that keeps landing within REST_DISTANCE of the same spot for
+// REST_TIME seconds is at rest: it only bounces there until it dies
+static const float REST_DISTANCE = 4.0f;
+static const float REST_TIME = 1.0f;
+
+static void updateParticlesScalar( ParticleStore *ps, int start, int end, float delta, float friction, float gravity );
+static void swapParticles( ParticleStore *ps, int a, int b );
+static void resetRestParticle( ParticleStore *ps, int i );
+
+#ifdef PARTICLE_X86_SIMD
+static void updateParticlesSSE( ParticleStore *ps, int start, int end, float delta, float friction, float gravity );
+static void updateParticlesAVX( ParticleStore *ps, int start, int end, float delta, float friction, float gravity );
+#endif
 
-    return (Particle){
-        .pos = pos,
-        .vel = vel,
-        .radius = radius,
-        .friction = 0.99,
-        .elasticity = 0.9,
-        .color = color
+ParticleStore createParticleStore( int capacity ) {
+
+    return (ParticleStore) {
+        .quantity = 0,
+        .capacity = capacity,
+        .awake = 0,
+        .x = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .y = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .prevX = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .prevY = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .vx = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .vy = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .radius = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .color = (Color*) allocAligned( capacity * sizeof( Color ), PARTICLE_ALIGNMENT ),
+        .age = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .lifetime = DEFAULT_LIFETIME,
+        .restX = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .restY = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .restAge = (float*) allocAligned( capacity * sizeof( float ), PARTICLE_ALIGNMENT ),
+        .friction = 0.99f,
+        .elasticity = 0.9f
     };
 
 }
 
-void updateParticle( Particle *particle, float delta ) {
+void destroyParticleStore( ParticleStore *ps ) {
+    freeAligned( ps->x );
+    freeAligned( ps->y );
+    freeAligned( ps->prevX );
+    freeAligned( ps->prevY );
+    freeAligned( ps->vx );
+    freeAligned( ps->vy );
+    freeAligned( ps->radius );
+    freeAligned( ps->color );
+    freeAligned( ps->age );
+    freeAligned( ps->restX );
+    freeAligned( ps->restY );
+    freeAligned( ps->restAge );
+    memset( ps, 0, sizeof( ParticleStore ) );
+}
+
+void setParticle( ParticleStore *ps, int index, Vector2 pos, Vector2 vel, float radius, Color color ) {
+    ps->x[index] = pos.x;
+    ps->y[index] = pos.y;
+    ps->prevX[index] = pos.x;
+    ps->prevY[index] = pos.y;
+    ps->vx[index] = vel.x;
+    ps->vy[index] = vel.y;
+    ps->radius[index] = radius;
+    ps->color[index] = color;
+    ps->age[index] = 0.0f;
+    resetRestParticle( ps, index );
+}
+
+/**
+ * @brief Integrates the particles in the [start, end) range: saves the
+ * current position as the previous one, moves them by their velocity,
+ * applies friction and gravity scaled to delta, clamps the fall speed and
+ * ages them.
+ * Uses AVX when the running CPU supports it, SSE otherwise.
+ */
+void updateParticles( ParticleStore *ps, int start, int end, float delta ) {
+
+    float friction = powf( ps->friction, delta * REFERENCE_RATE );
+    float gravity = GRAVITY * delta * REFERENCE_RATE;
+
+#ifdef PARTICLE_X86_SIMD
+    static int avxSupport = -1;
+    if ( avxSupport < 0 ) {
+        avxSupport = __builtin_cpu_supports( "avx" ) ? 1 : 0;
+    }
+    if ( avxSupport ) {
+        updateParticlesAVX( ps, start, end, delta, friction, gravity );
+    } else {
+        updateParticlesSSE( ps, start, end, delta, friction, gravity );
+    }
+#else
+    updateParticlesScalar( ps, start, end, delta, friction, gravity );
+#endif
+
+}
+
+/**
+ * @brief The speed of the fastest awake particle, 0 if there are none.
+ */
+float getMaxSpeedParticles( ParticleStore *ps ) {
+
+    float maxSpeed2 = 0.0f;
+
+    for ( int i = 0; i < ps->awake; i++ ) {
+        float speed2 = ps->vx[i] * ps->vx[i] + ps->vy[i] * ps->vy[i];
+        if ( speed2 > maxSpeed2 ) {
+            maxSpeed2 = speed2;
+        }
+    }
+
+    return sqrtf( maxSpeed2 );
 
-    particle->pos.x += particle->vel.x * delta;
-    particle->pos.y += particle->vel.y * delta;
+}
 
-    particle->vel.x = particle->vel.x * particle->friction;
-    particle->vel.y = particle->vel.y * particle->friction + GRAVITY;
+/**
+ * @brief Called when the particle lands on top of something. Returns true
+ * if it has been landing near the same spot for REST_TIME, otherwise the
+ * spot where it landed is where it starts to rest.
+ */
+bool updateRestParticle( ParticleStore *ps, int i ) {
 
-    if ( particle->vel.y >= MAX_FALL_SPEED ) {
-        particle->vel.y = MAX_FALL_SPEED;
+    if ( fabsf( ps->x[i] - ps->restX[i] ) < REST_DISTANCE && fabsf( ps->y[i] - ps->restY[i] ) < REST_DISTANCE ) {
+        return ps->age[i] - ps->restAge[i] >= REST_TIME;
     }
 
+    resetRestParticle( ps, i );
+    return false;
+
+}
+
+/**
+ * @brief Ages the sleeping particles by delta and puts to sleep the awake
+ * ones that were brought to rest (no velocity left), moving them to the
+ * end of the awake range. They stop where they are, so drawing doesn't
+ * interpolate them anymore.
+ */
+void settleParticles( ParticleStore *ps, float delta ) {
+
+    for ( int i = ps->awake; i < ps->quantity; i++ ) {
+        ps->age[i] += delta;
+    }
+
+    for ( int i = 0; i < ps->awake; ) {
+        if ( ps->vx[i] == 0.0f && ps->vy[i] == 0.0f ) {
+            ps->prevX[i] = ps->x[i];
+            ps->prevY[i] = ps->y[i];
+            swapParticles( ps, i, --ps->awake );
+        } else {
+            i++;
+        }
+    }
+
+}
+
+/**
+ * @brief Moves a sleeping particle to the end of the awake range. It
+ * starts to rest again from where it is.
+ */
+void wakeParticle( ParticleStore *ps, int i ) {
+
+    if ( i < ps->awake ) {
+        return;
+    }
+
+    resetRestParticle( ps, i );
+    swapParticles( ps, i, ps->awake++ );
+
+}
+
+/**
+ * @brief Wakes the sleeping particles that are within REST_DISTANCE of
+ * area, or all of them if area is NULL.
+ */
+void wakeParticles( ParticleStore *ps, const Rectangle *area ) {
+
+    for ( int i = ps->awake; i < ps->quantity; i++ ) {
+
+        if ( area != NULL ) {
+            float margin = ps->radius[i] + REST_DISTANCE;
+            if ( ps->x[i] < area->x - margin || ps->x[i] > area->x + area->width + margin ||
+                 ps->y[i] < area->y - margin || ps->y[i] > area->y + area->height + margin ) {
+                continue;
+            }
+        }
+
+        // the sleeping particle swapped into i was already checked
+        wakeParticle( ps, i );
+
+    }
+
+}
+
+/**
+ * @brief Removes the particles that outlived their lifetime or left the
+ * bounds through the sides or the bottom (the ones above the top still
+ * fall back). Keeps the order of the survivors and returns how many
+ * particles were removed.
+ */
+int compactParticles( ParticleStore *ps, Rectangle bounds ) {
+
+    float lifetime = ps->lifetime;
+    float minX = bounds.x;
+    float maxX = bounds.x + bounds.width;
+    float maxY = bounds.y + bounds.height;
+    int alive = 0;
+    int awake = 0;
+
+    for ( int i = 0; i < ps->quantity; i++ ) {
+
+        if ( ps->age[i] > lifetime || ps->x[i] < minX || ps->x[i] > maxX || ps->y[i] > maxY ) {
+            continue;
+        }
+
+        if ( i < ps->awake ) {
+            awake++;
+        }
+
+        if ( alive != i ) {
+            ps->x[alive] = ps->x[i];
+            ps->y[alive] = ps->y[i];
+            ps->prevX[alive] = ps->prevX[i];
+            ps->prevY[alive] = ps->prevY[i];
+            ps->vx[alive] = ps->vx[i];
+            ps->vy[alive] = ps->vy[i];
+            ps->radius[alive] = ps->radius[i];
+            ps->color[alive] = ps->color[i];
+            ps->age[alive] = ps->age[i];
+            ps->restX[alive] = ps->restX[i];
+            ps->restY[alive] = ps->restY[i];
+            ps->restAge[alive] = ps->restAge[i];
+        }
+
+        alive++;
+
+    }
+
+    int removed = ps->quantity - alive;
+    ps->quantity = alive;
+    ps->awake = awake;
+
+    return removed;
+
+}
+
+static void swapParticles( ParticleStore *ps, int a, int b ) {
+
+    if ( a == b ) {
+        return;
+    }
+
+    float *floats[] = { ps->x, ps->y, ps->prevX, ps->prevY, ps->vx, ps->vy, ps->radius, ps->age, ps->restX, ps->restY, ps->restAge };
+
+    for ( int f = 0; f < (int) ( sizeof( floats ) / sizeof( floats[0] ) ); f++ ) {
+        float t = floats[f][a];
+        floats[f][a] = floats[f][b];
+        floats[f][b] = t;
+    }
+
+    Color c = ps->color[a];
+    ps->color[a] = ps->color[b];
+    ps->color[b] = c;
+
+}
+
+static void resetRestParticle( ParticleStore *ps, int i ) {
+    ps->restX[i] = ps->x[i];
+    ps->restY[i] = ps->y[i];
+    ps->restAge[i] = ps->age[i];
+}
+
+static void updateParticlesScalar( ParticleStore *ps, int start, int end, float delta, float friction, float gravity ) {
+
+    float *x = ps->x;
+    float *y = ps->y;
+    float *prevX = ps->prevX;
+    float *prevY = ps->prevY;
+    float *vx = ps->vx;
+    float *vy = ps->vy;
+    float *age = ps->age;
+
+    for ( int i = start; i < end; i++ ) {
+
+        age[i] += delta;
+
+        prevX[i] = x[i];
+        prevY[i] = y[i];
+
+        x[i] += vx[i] * delta;
+        y[i] += vy[i] * delta;
+
+        vx[i] = vx[i] * friction;
+        vy[i] = vy[i] * friction + gravity;
+
+        if ( vy[i] >= MAX_FALL_SPEED ) {
+            vy[i] = MAX_FALL_SPEED;
+        }
+
+    }
+
+}
+
+#ifdef PARTICLE_X86_SIMD
+
+static void updateParticlesSSE( ParticleStore *ps, int start, int end, float delta, float friction, float gravity ) {
+
+    float *x = ps->x;
+    float *y = ps->y;
+    float *prevX = ps->prevX;
+    float *prevY = ps->prevY;
+    float *vx = ps->vx;
+    float *vy = ps->vy;
+    float *age = ps->age;
+
+    __m128 d = _mm_set1_ps( delta );
+    __m128 f = _mm_set1_ps( friction );
+    __m128 g = _mm_set1_ps( gravity );
+    __m128 m = _mm_set1_ps( MAX_FALL_SPEED );
+
+    int i = start;
+
+    for ( ; i + 4 <= end; i += 4 ) {
+
+        __m128 cx = _mm_loadu_ps( x + i );
+        __m128 cy = _mm_loadu_ps( y + i );
+        __m128 cvx = _mm_loadu_ps( vx + i );
+        __m128 cvy = _mm_loadu_ps( vy + i );
+
+        _mm_storeu_ps( prevX + i, cx );
+        _mm_storeu_ps( prevY + i, cy );
+        _mm_storeu_ps( x + i, _mm_add_ps( cx, _mm_mul_ps( cvx, d ) ) );
+        _mm_storeu_ps( y + i, _mm_add_ps( cy, _mm_mul_ps( cvy, d ) ) );
+
+        _mm_storeu_ps( vx + i, _mm_mul_ps( cvx, f ) );
+        _mm_storeu_ps( vy + i, _mm_min_ps( _mm_add_ps( _mm_mul_ps( cvy, f ), g ), m ) );
+        _mm_storeu_ps( age + i, _mm_add_ps( _mm_loadu_ps( age + i ), d ) );
+
+    }
+
+    updateParticlesScalar( ps, i, end, delta, friction, gravity );
+
+}
+
+__attribute__(( target( "avx" ) ))
+static void updateParticlesAVX( ParticleStore *ps, int start, int end, float delta, float friction, float gravity ) {
+
+    float *x = ps->x;
+    float *y = ps->y;
+    float *prevX = ps->prevX;
+    float *prevY = ps->prevY;
+    float *vx = ps->vx;
+    float *vy = ps->vy;
+    float *age = ps->age;
+
+    __m256 d = _mm256_set1_ps( delta );
+    __m256 f = _mm256_set1_ps( friction );
+    __m256 g = _mm256_set1_ps( gravity );
+    __m256 m = _mm256_set1_ps( MAX_FALL_SPEED );
+
+    int i = start;
+
+    for ( ; i + 8 <= end; i += 8 ) {
+
+        __m256 cx = _mm256_loadu_ps( x + i );
+        __m256 cy = _mm256_loadu_ps( y + i );
+        __m256 cvx = _mm256_loadu_ps( vx + i );
+        __m256 cvy = _mm256_loadu_ps( vy + i );
+
+        _mm256_storeu_ps( prevX + i, cx );
+        _mm256_storeu_ps( prevY + i, cy );
+        _mm256_storeu_ps( x + i, _mm256_add_ps( cx, _mm256_mul_ps( cvx, d ) ) );
+        _mm256_storeu_ps( y + i, _mm256_add_ps( cy, _mm256_mul_ps( cvy, d ) ) );
+
+        _mm256_storeu_ps( vx + i, _mm256_mul_ps( cvx, f ) );
+        _mm256_storeu_ps( vy + i, _mm256_min_ps( _mm256_add_ps( _mm256_mul_ps( cvy, f ), g ), m ) );
+        _mm256_storeu_ps( age + i, _mm256_add_ps( _mm256_loadu_ps( age + i ), d ) );
+
+    }
+
+    updateParticlesSSE( ps, i, end, delta, friction, gravity );
+
 }
 
-void drawParticle( Particle *particle ) {
-    DrawCircleV( particle->pos, particle->radius, particle->color );
-}
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -1,15 +1,19 @@
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
 #include "Particle.h"
 #include "ParticleEmitter.h"
+#include "Random.h"
 #include "GameWorld.h"
-#include "utils.h"
 #include "raylib/raylib.h"
 #include "raylib/raymath.h"
 
-#define PE_RANDOM_MULTIPLIER 1000.0f
+// random values are drawn in batches of up to this many particles
+#define PE_BATCH_SIZE 64
+
+static Color getColorParticleEmitter( ParticleEmitter *pe, float startHue, float endHue );
 
 ParticleEmitter createParticleEmitter( Vector2 pos, Vector2 vel, float launchAngle, float posAngleVel, float hueAngleVel, float radius, bool draggable, int maxParticles ) {
 
@@ -23,32 +27,30 @@ ParticleEmitter createParticleEmitter( Vector2 pos, Vector2 vel, float launchAng
         .hueAngleVel = hueAngleVel,
         .radius = radius,
         .draggable = draggable,
+        .emissionCarry = 0.0f,
         .newParticlePos = 0,
-        .particleQuantity = 0,
-        .maxParticles = maxParticles,
-        .particles = (Particle*) malloc( maxParticles * sizeof( Particle ) )
+        .random = createRandom( 0 ),
+        .particles = createParticleStore( maxParticles )
     };
 
 }
 
 void destroyParticleEmitter( ParticleEmitter *pe ) {
-    free( pe->particles );
+    destroyParticleStore( &pe->particles );
 }
 
-void drawParticleEmitter( ParticleEmitter *pe ) {
+void drawParticleEmitter( ParticleEmitter *pe, ParticleRenderer *pr, float alpha ) {
 
     if ( pe->draggable && pe->mouseOver ) {
         DrawCircleV( pe->pos, pe->radius, Fade( RAYWHITE, 0.5f ) );    
         DrawCircleLinesV( pe->pos, pe->radius, RAYWHITE );
     }
 
-    for ( int i = 0; i < pe->particleQuantity; i++ ) {
-        drawParticle( &pe->particles[i] );
-    }
+    drawParticlesParticleRenderer( pr, &pe->particles, alpha );
 
 }
 
-void updateParticleEmitterMoveSin( ParticleEmitter *pe, float delta ) {
+void updateParticleEmitterMoveSin( ParticleEmitter *pe, float delta, int screenWidth ) {
 
     pe->pos.x += pe->vel.x * delta;
     pe->pos.y += pe->vel.y * sin( DEG2RAD * pe->posAngle ) * delta;
@@ -62,24 +64,25 @@ void updateParticleEmitterMoveSin( ParticleEmitter *pe, float delta ) {
 
     if ( pe->pos.x < 40.0f ) {
         pe->vel.x *= -1.0f;
-    } else if ( pe->pos.x >= GetScreenWidth() - 40.0f ) {
+    } else if ( pe->pos.x >= screenWidth - 40.0f ) {
         pe->vel.x *= -1.0f;
     }
 
-    for ( int i = 0; i < pe->particleQuantity; i++ ) {
-        updateParticle( &pe->particles[i], delta );
-    }
-
 }
 
 void updateParticleEmitterStatic( ParticleEmitter *pe, float delta ) {
-
     updateHueAngleBouncing( pe, delta );
+}
 
-    for ( int i = 0; i < pe->particleQuantity; i++ ) {
-        updateParticle( &pe->particles[i], delta );
-    }
-
+/**
+ * @brief How many particles to emit in a step of delta seconds to keep the
+ * given rate, carrying the fractional part over to the next step.
+ */
+int getEmissionQuantityParticleEmitter( ParticleEmitter *pe, float particlesPerSecond, float delta ) {
+    float quantity = particlesPerSecond * delta + pe->emissionCarry;
+    int whole = (int) quantity;
+    pe->emissionCarry = quantity - whole;
+    return whole;
 }
 
 void updateHueAngleBouncing( ParticleEmitter *pe, float delta ) {
@@ -96,11 +99,23 @@ void updateHueAngleBouncing( ParticleEmitter *pe, float delta ) {
     
 }
 
+/**
+ * @brief Reseeds the emitter random number generator.
+ */
+void setSeedParticleEmitter( ParticleEmitter *pe, uint64_t seed ) {
+    pe->random = createRandom( seed );
+}
+
 void emitParticle( ParticleEmitter *pe, Vector2 pos, Vector2 vel, float radius, Color color ) {
 
-    int k = pe->newParticlePos % pe->maxParticles;
+    ParticleStore *ps = &pe->particles;
+
+    // appends while there is room, overwrites like a ring when full
+    int k = ps->quantity < ps->capacity ? ps->quantity : pe->newParticlePos % ps->capacity;
 
-    pe->particles[k] = createParticle( 
+    setParticle( 
+        ps,
+        k,
         pos, 
         vel,
         radius,
@@ -109,10 +124,13 @@ void emitParticle( ParticleEmitter *pe, Vector2 pos, Vector2 vel, float radius,
 
     pe->newParticlePos++;
 
-    if ( pe->particleQuantity < pe->maxParticles ) {
-        pe->particleQuantity++;
+    if ( ps->quantity < ps->capacity ) {
+        ps->quantity++;
     }
 
+    // new particles (and the ones that replace sleeping ones) are awake
+    wakeParticle( ps, k );
+
 }
 
 void emitParticleColorInterval( ParticleEmitter *pe, Vector2 vel, float minRadius, float maxRadius, float startHue, float endHue ) {
@@ -124,12 +142,8 @@ void emitParticlePositionColorInterval( ParticleEmitter *pe, Vector2 pos, Vector
         pe, 
         pos, 
         vel, 
-        GetRandomValue( (int) (minRadius * PE_RANDOM_MULTIPLIER), (int) (maxRadius * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER,
-        ColorFromHSV( 
-            Lerp( startHue, endHue, pe->hueAngle / 360.0f ), 
-            1.0f, 
-            1.0f
-        )
+        nextFloatRandom( &pe->random, minRadius, maxRadius ),
+        getColorParticleEmitter( pe, startHue, endHue )
     );
 }
 
@@ -150,19 +164,17 @@ void emitParticleColorIntervalQuantity(
     float minRadius, float maxRadius, 
     float startHue, float endHue, 
     int quantity ) {
-    
-    for ( int i = 0; i < quantity; i++ ) {
-        emitParticleColorInterval( 
-            pe, 
-            createVel( 
-                GetRandomValue( (int) (minVelX * PE_RANDOM_MULTIPLIER), (int) (maxVelX * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER, 
-                GetRandomValue( (int) (minVelY * PE_RANDOM_MULTIPLIER), (int) (maxVelY * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER, 
-                randomSignX, randomSignY
-            ),
-            minRadius, maxRadius,
-            startHue, endHue
-        );
-    }
+
+    emitParticlePositionColorIntervalQuantity( 
+        pe, 
+        pe->pos,
+        minVelX, maxVelX,
+        minVelY, maxVelY,
+        randomSignX, randomSignY,
+        minRadius, maxRadius,
+        startHue, endHue,
+        quantity
+    );
     
 }
 
@@ -175,19 +187,31 @@ void emitParticlePositionColorIntervalQuantity(
     float minRadius, float maxRadius, 
     float startHue, float endHue, 
     int quantity ) {
-    
-    for ( int i = 0; i < quantity; i++ ) {
-        emitParticlePositionColorInterval( 
-            pe, 
-            pos,
-            createVel( 
-                GetRandomValue( (int) (minVelX * PE_RANDOM_MULTIPLIER), (int) (maxVelX * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER, 
-                GetRandomValue( (int) (minVelY * PE_RANDOM_MULTIPLIER), (int) (maxVelY * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER, 
-                randomSignX, randomSignY
-            ),
-            minRadius, maxRadius,
-            startHue, endHue
-        );
+
+    float velX[PE_BATCH_SIZE];
+    float velY[PE_BATCH_SIZE];
+    float radius[PE_BATCH_SIZE];
+    Color color = getColorParticleEmitter( pe, startHue, endHue );
+
+    for ( int done = 0; done < quantity; done += PE_BATCH_SIZE ) {
+
+        int n = quantity - done < PE_BATCH_SIZE ? quantity - done : PE_BATCH_SIZE;
+
+        fillFloatRandom( &pe->random, velX, n, minVelX, maxVelX );
+        fillFloatRandom( &pe->random, velY, n, minVelY, maxVelY );
+        fillFloatRandom( &pe->random, radius, n, minRadius, maxRadius );
+
+        if ( randomSignX ) {
+            flipSignRandom( &pe->random, velX, n );
+        }
+        if ( randomSignY ) {
+            flipSignRandom( &pe->random, velY, n );
+        }
+
+        for ( int i = 0; i < n; i++ ) {
+            emitParticle( pe, pos, (Vector2) { velX[i], velY[i] }, radius[i], color );
+        }
+
     }
 
 }
@@ -201,28 +225,16 @@ void emitParticlePolarColorIntervalQuantity(
     float startHue, float endHue, 
     int quantity ) {
 
-    for ( int i = 0; i < quantity; i++ ) {
-
-        float rVel = GetRandomValue( (int) (minVel * PE_RANDOM_MULTIPLIER), (int) (maxVel * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER;
-        float launAngleOffset = GetRandomValue( (int) (minLaunchAngle * PE_RANDOM_MULTIPLIER), (int) (maxLaunchAngle * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER;
-
-        if ( randomSignLaunchAnble ) {
-            if ( GetRandomValue( 0, 1 ) == 0 ) {
-                launAngleOffset *= -1.0f;
-            }
-        }
-
-        emitParticleColorInterval( 
-            pe, 
-            createVel( 
-                rVel * sin( DEG2RAD * ( pe->launchAngle + launAngleOffset ) ), 
-                rVel * cos( DEG2RAD * ( pe->launchAngle + launAngleOffset ) ), 
-                false, false
-            ),
-            minRadius, maxRadius,
-            startHue, endHue
-        );
-    }
+    emitParticlePolarPositionColorIntervalQuantity( 
+        pe, 
+        pe->pos,
+        minVel, maxVel,
+        minLaunchAngle, maxLaunchAngle,
+        randomSignLaunchAnble,
+        minRadius, maxRadius,
+        startHue, endHue,
+        quantity
+    );
     
 }
 
@@ -236,28 +248,46 @@ void emitParticlePolarPositionColorIntervalQuantity(
     float startHue, float endHue, 
     int quantity ) {
 
-    for ( int i = 0; i < quantity; i++ ) {
+    float rVel[PE_BATCH_SIZE];
+    float launchAngleOffset[PE_BATCH_SIZE];
+    float radius[PE_BATCH_SIZE];
+    Color color = getColorParticleEmitter( pe, startHue, endHue );
+
+    for ( int done = 0; done < quantity; done += PE_BATCH_SIZE ) {
 
-        float rVel = GetRandomValue( (int) (minVel * PE_RANDOM_MULTIPLIER), (int) (maxVel * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER;
-        float launAngleOffset = GetRandomValue( (int) (minLaunchAngle * PE_RANDOM_MULTIPLIER), (int) (maxLaunchAngle * PE_RANDOM_MULTIPLIER) ) / PE_RANDOM_MULTIPLIER;
+        int n = quantity - done < PE_BATCH_SIZE ? quantity - done : PE_BATCH_SIZE;
+
+        fillFloatRandom( &pe->random, rVel, n, minVel, maxVel );
+        fillFloatRandom( &pe->random, launchAngleOffset, n, minLaunchAngle, maxLaunchAngle );
+        fillFloatRandom( &pe->random, radius, n, minRadius, maxRadius );
 
         if ( randomSignLaunchAnble ) {
-            if ( GetRandomValue( 0, 1 ) == 0 ) {
-                launAngleOffset *= -1.0f;
-            }
+            flipSignRandom( &pe->random, launchAngleOffset, n );
+        }
+
+        for ( int i = 0; i < n; i++ ) {
+            float angle = DEG2RAD * ( pe->launchAngle + launchAngleOffset[i] );
+            emitParticle( 
+                pe, 
+                pos,
+                (Vector2) { rVel[i] * sinf( angle ), rVel[i] * cosf( angle ) },
+                radius[i],
+                color
+            );
         }
 
-        emitParticlePositionColorInterval( 
-            pe, 
-            pos,
-            createVel( 
-                rVel * sin( DEG2RAD * ( pe->launchAngle + launAngleOffset ) ), 
-                rVel * cos( DEG2RAD * ( pe->launchAngle + launAngleOffset ) ), 
-                false, false
-            ),
-            minRadius, maxRadius,
-            startHue, endHue
-        );
     }
 
 }
+
+/**
+ * @brief Color of the particles emitted now: the hue walks from startHue
+ * to endHue following the emitter hue angle.
+ */
+static Color getColorParticleEmitter( ParticleEmitter *pe, float startHue, float endHue ) {
+    return ColorFromHSV( 
+        Lerp( startHue, endHue, pe->hueAngle / 360.0f ), 
+        1.0f, 
+        1.0f
+    );
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+/**
+ * @file ParticleRenderer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ParticleRenderer implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "ParticleRenderer.h"
+#include "Particle.h"
+#include "Trace.h"
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+#define CIRCLE_TEXTURE_SIZE 64
+
+// on screen radius (px) under which a particle is a single pixel
+#define PIXEL_RADIUS 0.5f
+
+// on screen radius (px) above which the texture would be magnified
+#define CIRCLE_RADIUS ( CIRCLE_TEXTURE_SIZE / 2.0f )
+
+// on screen length (px) of each segment of the tessellated circles
+#define CIRCLE_SEGMENT_LENGTH 4.0f
+#define CIRCLE_MIN_SEGMENTS 16
+#define CIRCLE_MAX_SEGMENTS 256
+
+static int drawPixels( ParticleRenderer *pr, ParticleStore *ps, float alpha, float maxRadius );
+static int drawSprites( ParticleRenderer *pr, ParticleStore *ps, float alpha, float minRadius, float maxRadius );
+static int drawCircles( ParticleRenderer *pr, ParticleStore *ps, float alpha, float minRadius );
+static inline bool isVisible( Rectangle view, float x, float y, float r );
+static Texture2D createCircleTexture( int size );
+
+/**
+ * @brief Creates the circle texture and a render batch able to hold
+ * maxParticles quads. Needs an OpenGL context.
+ */
+ParticleRenderer createParticleRenderer( int maxParticles ) {
+    return (ParticleRenderer) {
+        .initialized = true,
+        .circleTexture = createCircleTexture( CIRCLE_TEXTURE_SIZE ),
+        .batch = rlLoadRenderBatch( 1, maxParticles ),
+        .batchCapacity = maxParticles,
+        .view = { 0 },
+        .zoom = 1.0f
+    };
+}
+
+/**
+ * @brief Unloads the texture and the render batch.
+ */
+void destroyParticleRenderer( ParticleRenderer *pr ) {
+    if ( pr->initialized ) {
+        UnloadTexture( pr->circleTexture );
+        rlUnloadRenderBatch( pr->batch );
+        pr->initialized = false;
+    }
+}
+
+/**
+ * @brief Resets the per frame draw statistics and sets the world view
+ * (used for culling) and zoom of the camera the particles will be drawn
+ * with.
+ */
+void beginFrameParticleRenderer( ParticleRenderer *pr, Rectangle view, float zoom ) {
+    pr->view = view;
+    pr->zoom = zoom > 0.0f ? zoom : 1.0f;
+    pr->drawnParticles = 0;
+    pr->drawnVertices = 0;
+}
+
+/**
+ * @brief Draws every particle of the store in a single batch, at
+ * alpha (0 to 1) of the way between its previous and current positions.
+ * The store is walked once per level of detail, so each level becomes a
+ * single draw call. Particles outside of the view are skipped.
+ */
+void drawParticlesParticleRenderer( ParticleRenderer *pr, ParticleStore *ps, float alpha ) {
+
+    double traceStart = beginTraceZone();
+
+    // world radii where the level of detail changes
+    float pixelRadius = PIXEL_RADIUS / pr->zoom;
+    float circleRadius = CIRCLE_RADIUS / pr->zoom;
+    int drawn = 0;
+
+    // switching batches flushes whatever was queued in the default one
+    rlSetRenderBatchActive( &pr->batch );
+
+    drawn += drawPixels( pr, ps, alpha, pixelRadius );
+
+    rlSetTexture( pr->circleTexture.id );
+    drawn += drawSprites( pr, ps, alpha, pixelRadius, circleRadius );
+    drawn += drawCircles( pr, ps, alpha, circleRadius );
+    rlSetTexture( 0 );
+
+    // switching back uploads and draws the particle batch
+    rlSetRenderBatchActive( NULL );
+
+    endTraceZone( "particle batch", traceStart );
+    pr->drawnParticles += drawn;
+
+}
+
+/**
+ * @brief Particles with radius below maxRadius cover at most a pixel: a
+ * line one pixel long lights it with two vertices. The draw functions
+ * return how many particles they drew.
+ */
+static int drawPixels( ParticleRenderer *pr, ParticleStore *ps, float alpha, float maxRadius ) {
+
+    float halfPixel = 0.5f / pr->zoom;
+    int drawn = 0;
+
+    rlBegin( RL_LINES );
+
+    for ( int i = 0; i < ps->quantity; i++ ) {
+
+        if ( ps->radius[i] >= maxRadius ) {
+            continue;
+        }
+
+        float x = ps->prevX[i] + ( ps->x[i] - ps->prevX[i] ) * alpha;
+        float y = ps->prevY[i] + ( ps->y[i] - ps->prevY[i] ) * alpha;
+
+        if ( !isVisible( pr->view, x, y, halfPixel ) ) {
+            continue;
+        }
+
+        Color c = ps->color[i];
+
+        rlColor4ub( c.r, c.g, c.b, c.a );
+        rlVertex2f( x - halfPixel, y );
+        rlVertex2f( x + halfPixel, y );
+        drawn++;
+
+    }
+
+    rlEnd();
+    pr->drawnVertices += drawn * 2;
+
+    return drawn;
+
+}
+
+/**
+ * @brief Particles with radius in [minRadius, maxRadius) are quads
+ * sampling the circle texture.
+ */
+static int drawSprites( ParticleRenderer *pr, ParticleStore *ps, float alpha, float minRadius, float maxRadius ) {
+
+    int drawn = 0;
+
+    rlBegin( RL_QUADS );
+
+    for ( int i = 0; i < ps->quantity; i++ ) {
+
+        float r = ps->radius[i];
+
+        if ( r < minRadius || r >= maxRadius ) {
+            continue;
+        }
+
+        float x = ps->prevX[i] + ( ps->x[i] - ps->prevX[i] ) * alpha;
+        float y = ps->prevY[i] + ( ps->y[i] - ps->prevY[i] ) * alpha;
+
+        if ( !isVisible( pr->view, x, y, r ) ) {
+            continue;
+        }
+
+        float x0 = x - r;
+        float y0 = y - r;
+        float x1 = x + r;
+        float y1 = y + r;
+        Color c = ps->color[i];
+
+        rlColor4ub( c.r, c.g, c.b, c.a );
+        rlTexCoord2f( 0.0f, 0.0f );
+        rlVertex2f( x0, y0 );
+        rlTexCoord2f( 0.0f, 1.0f );
+        rlVertex2f( x0, y1 );
+        rlTexCoord2f( 1.0f, 1.0f );
+        rlVertex2f( x1, y1 );
+        rlTexCoord2f( 1.0f, 0.0f );
+        rlVertex2f( x1, y0 );
+        drawn++;
+
+    }
+
+    rlEnd();
+    pr->drawnVertices += drawn * 4;
+
+    return drawn;
+
+}
+
+/**
+ * @brief Particles with radius from minRadius on would blur the texture,
+ * so they are tessellated with CIRCLE_SEGMENT_LENGTH pixel segments, two
+ * per quad (the quad fan DrawCircleSector uses). Every vertex samples the
+ * opaque center of the circle texture, so they stay in the sprite draw
+ * call.
+ */
+static int drawCircles( ParticleRenderer *pr, ParticleStore *ps, float alpha, float minRadius ) {
+
+    int drawn = 0;
+
+    rlBegin( RL_QUADS );
+    rlTexCoord2f( 0.5f, 0.5f );
+
+    for ( int i = 0; i < ps->quantity; i++ ) {
+
+        float r = ps->radius[i];
+
+        if ( r < minRadius ) {
+            continue;
+        }
+
+        float x = ps->prevX[i] + ( ps->x[i] - ps->prevX[i] ) * alpha;
+        float y = ps->prevY[i] + ( ps->y[i] - ps->prevY[i] ) * alpha;
+
+        if ( !isVisible( pr->view, x, y, r ) ) {
+            continue;
+        }
+
+        int segments = (int) ( 2.0f * PI * r * pr->zoom / CIRCLE_SEGMENT_LENGTH );
+        segments = segments < CIRCLE_MIN_SEGMENTS ? CIRCLE_MIN_SEGMENTS : segments > CIRCLE_MAX_SEGMENTS ? CIRCLE_MAX_SEGMENTS : segments;
+        segments += segments % 2;
+
+        float stepCos = cosf( 2.0f * PI / segments );
+        float stepSin = sinf( 2.0f * PI / segments );
+        float dx = r;
+        float dy = 0.0f;
+        Color c = ps->color[i];
+
+        rlColor4ub( c.r, c.g, c.b, c.a );
+
+        for ( int s = 0; s < segments; s += 2 ) {
+
+            float dx1 = dx * stepCos - dy * stepSin;
+            float dy1 = dx * stepSin + dy * stepCos;
+            float dx2 = dx1 * stepCos - dy1 * stepSin;
+            float dy2 = dx1 * stepSin + dy1 * stepCos;
+
+            rlVertex2f( x, y );
+            rlVertex2f( x + dx2, y + dy2 );
+            rlVertex2f( x + dx1, y + dy1 );
+            rlVertex2f( x + dx, y + dy );
+
+            dx = dx2;
+            dy = dy2;
+
+        }
+
+        pr->drawnVertices += segments * 2;
+        drawn++;
+
+    }
+
+    rlEnd();
+
+    return drawn;
+
+}
+
+static inline bool isVisible( Rectangle view, float x, float y, float r ) {
+    return x + r >= view.x && x - r <= view.x + view.width && y + r >= view.y && y - r <= view.y + view.height;
+}
+
+/**
+ * @brief White anti-aliased disc over a transparent background, tinted by
+ * the vertex color when drawn.
+ */
+static Texture2D createCircleTexture( int size ) {
+
+    Image image = GenImageColor( size, size, BLANK );
+    Color *pixels = (Color*) image.data;
+    float center = size / 2.0f;
+    float radius = size / 2.0f - 1.0f;
+
+    for ( int y = 0; y < size; y++ ) {
+        for ( int x = 0; x < size; x++ ) {
+            float dx = x + 0.5f - center;
+            float dy = y + 0.5f - center;
+            float coverage = radius - sqrtf( dx * dx + dy * dy ) + 0.5f;
+            coverage = coverage < 0.0f ? 0.0f : coverage > 1.0f ? 1.0f : coverage;
+            pixels[y * size + x] = (Color) { 255, 255, 255, (unsigned char) ( coverage * 255.0f ) };
+        }
+    }
+
+    Texture2D texture = LoadTextureFromImage( image );
+    UnloadImage( image );
+
+    GenTextureMipmaps( &texture );
+    SetTextureFilter( texture, TEXTURE_FILTER_TRILINEAR );
+
+    return texture;
+
+}
\ No newline at end of file
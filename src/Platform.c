@@ -0,0 +1,152 @@
+/**
+ * @file Platform.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Operating system services implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <stddef.h>
+
+#include "Platform.h"
+
+/**
+ * @brief Returns the time, in seconds, of a monotonic high resolution
+ * clock. Works without a window, unlike raylib GetTime.
+ */
+double getTimePlatform( void ) {
+
+#if defined( _WIN32 )
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if ( frequency.QuadPart == 0 ) {
+        QueryPerformanceFrequency( &frequency );
+    }
+    QueryPerformanceCounter( &counter );
+    return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+
+}
+
+/**
+ * @brief Suspends the calling thread for about the given time.
+ */
+void sleepPlatform( double seconds ) {
+
+    if ( seconds <= 0.0 ) {
+        return;
+    }
+
+#if defined( _WIN32 )
+    Sleep( (DWORD) ( seconds * 1000.0 ) );
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t) seconds;
+    ts.tv_nsec = (long) ( ( seconds - ts.tv_sec ) * 1e9 );
+    nanosleep( &ts, NULL );
+#endif
+
+}
+
+/**
+ * @brief Returns the number of logical processors available.
+ */
+int getProcessorCountPlatform( void ) {
+
+#if defined( _WIN32 )
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return (int) info.dwNumberOfProcessors;
+#else
+    long count = sysconf( _SC_NPROCESSORS_ONLN );
+    return count > 0 ? (int) count : 1;
+#endif
+
+}
+
+/**
+ * @brief Maps a whole file in memory, read only. Returns NULL if the file
+ * can't be opened or is empty; otherwise *size receives its size in
+ * bytes. Release it with unmapFilePlatform.
+ */
+const void *mapFilePlatform( const char *fileName, long long *size ) {
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileA( fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if ( file == INVALID_HANDLE_VALUE ) {
+        return NULL;
+    }
+
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart == 0 ) {
+        CloseHandle( file );
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    CloseHandle( file );
+    if ( mapping == NULL ) {
+        return NULL;
+    }
+
+    // the view keeps the mapping alive
+    const void *data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    CloseHandle( mapping );
+
+    *size = fileSize.QuadPart;
+    return data;
+#else
+    int file = open( fileName, O_RDONLY );
+    if ( file < 0 ) {
+        return NULL;
+    }
+
+    struct stat info;
+    if ( fstat( file, &info ) != 0 || info.st_size == 0 ) {
+        close( file );
+        return NULL;
+    }
+
+    void *data = mmap( NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0 );
+    close( file );
+    if ( data == MAP_FAILED ) {
+        return NULL;
+    }
+
+    *size = info.st_size;
+    return data;
+#endif
+
+}
+
+/**
+ * @brief Releases a file mapped with mapFilePlatform.
+ */
+void unmapFilePlatform( const void *data, long long size ) {
+
+    if ( data == NULL ) {
+        return;
+    }
+
+#if defined( _WIN32 )
+    UnmapViewOfFile( data );
+#else
+    munmap( (void*) data, size );
+#endif
+
+}
\ No newline at end of file
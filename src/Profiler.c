@@ -0,0 +1,181 @@
+/**
+ * @file Profiler.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Profiler implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "Profiler.h"
+#include "Platform.h"
+#include "Trace.h"
+
+Profiler profiler = { 0 };
+
+// the simulation and the drawing zones end in different threads
+static pthread_mutex_t profilerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *zoneNames[PROFILER_ZONE_COUNT] = {
+    "emit",
+    "integrate",
+    "collide",
+    "compact",
+    "obstacle draw",
+    "particle draw",
+    "present",
+    "frame"
+};
+
+static int compareSamples( const void *a, const void *b );
+
+void beginProfilerZone( ProfilerZone zone ) {
+    profiler.start[zone] = getTimePlatform();
+}
+
+void endProfilerZone( ProfilerZone zone ) {
+    double elapsed = getTimePlatform() - profiler.start[zone];
+    pthread_mutex_lock( &profilerMutex );
+    profiler.total[zone] += elapsed;
+    profiler.current[zone] += elapsed;
+    profiler.calls[zone]++;
+    pthread_mutex_unlock( &profilerMutex );
+    endTraceZone( zoneNames[zone], profiler.start[zone] );
+}
+
+void resetProfiler( void ) {
+    memset( &profiler, 0, sizeof( Profiler ) );
+}
+
+const char *getNameProfilerZone( ProfilerZone zone ) {
+    return zoneNames[zone];
+}
+
+void endFrameProfiler( void ) {
+
+    double now = getTimePlatform();
+
+    pthread_mutex_lock( &profilerMutex );
+
+    if ( profiler.frameStart > 0.0 ) {
+        double elapsed = now - profiler.frameStart;
+        profiler.total[PROFILER_ZONE_FRAME] += elapsed;
+        profiler.current[PROFILER_ZONE_FRAME] = elapsed;
+        profiler.calls[PROFILER_ZONE_FRAME]++;
+    }
+
+    profiler.frameStart = now;
+
+    for ( int i = PROFILER_STEP_ZONE_COUNT; i < PROFILER_ZONE_COUNT; i++ ) {
+        profiler.samples[i][profiler.nextSample] = profiler.current[i];
+        profiler.current[i] = 0.0;
+    }
+
+    profiler.nextSample = ( profiler.nextSample + 1 ) % PROFILER_WINDOW_SIZE;
+    if ( profiler.sampleQuantity < PROFILER_WINDOW_SIZE ) {
+        profiler.sampleQuantity++;
+    }
+
+    pthread_mutex_unlock( &profilerMutex );
+
+}
+
+void endStepProfiler( void ) {
+
+    pthread_mutex_lock( &profilerMutex );
+
+    for ( int i = 0; i < PROFILER_STEP_ZONE_COUNT; i++ ) {
+        profiler.samples[i][profiler.nextStepSample] = profiler.current[i];
+        profiler.current[i] = 0.0;
+    }
+
+    profiler.nextStepSample = ( profiler.nextStepSample + 1 ) % PROFILER_WINDOW_SIZE;
+    if ( profiler.stepSampleQuantity < PROFILER_WINDOW_SIZE ) {
+        profiler.stepSampleQuantity++;
+    }
+
+    pthread_mutex_unlock( &profilerMutex );
+
+}
+
+ProfilerStats getStatsProfilerZone( ProfilerZone zone ) {
+
+    ProfilerStats stats = { 0 };
+    double sorted[PROFILER_WINDOW_SIZE];
+
+    pthread_mutex_lock( &profilerMutex );
+    int n = zone < PROFILER_STEP_ZONE_COUNT ? profiler.stepSampleQuantity : profiler.sampleQuantity;
+    memcpy( sorted, profiler.samples[zone], n * sizeof( double ) );
+    pthread_mutex_unlock( &profilerMutex );
+
+    if ( n == 0 ) {
+        return stats;
+    }
+
+    // the ring isn't in time order, but statistics don't care
+    qsort( sorted, n, sizeof( double ), compareSamples );
+
+    for ( int i = 0; i < n; i++ ) {
+        stats.mean += sorted[i];
+    }
+
+    stats.mean /= n;
+    stats.p50 = sorted[( n - 1 ) * 50 / 100];
+    stats.p99 = sorted[( n - 1 ) * 99 / 100];
+    stats.max = sorted[n - 1];
+
+    return stats;
+
+}
+
+bool saveCSVProfiler( const char *fileName ) {
+
+    FILE *file = fopen( fileName, "w" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    fprintf( file, "sample" );
+    for ( int i = 0; i < PROFILER_ZONE_COUNT; i++ ) {
+        fprintf( file, ",%s (ms)", zoneNames[i] );
+    }
+    fprintf( file, "\n" );
+
+    pthread_mutex_lock( &profilerMutex );
+
+    int firstStep = ( profiler.nextStepSample - profiler.stepSampleQuantity + PROFILER_WINDOW_SIZE ) % PROFILER_WINDOW_SIZE;
+    int firstFrame = ( profiler.nextSample - profiler.sampleQuantity + PROFILER_WINDOW_SIZE ) % PROFILER_WINDOW_SIZE;
+    int lines = profiler.stepSampleQuantity > profiler.sampleQuantity ? profiler.stepSampleQuantity : profiler.sampleQuantity;
+
+    for ( int k = 0; k < lines; k++ ) {
+        fprintf( file, "%d", k );
+        for ( int i = 0; i < PROFILER_ZONE_COUNT; i++ ) {
+            bool step = i < PROFILER_STEP_ZONE_COUNT;
+            if ( k < ( step ? profiler.stepSampleQuantity : profiler.sampleQuantity ) ) {
+                int s = ( ( step ? firstStep : firstFrame ) + k ) % PROFILER_WINDOW_SIZE;
+                fprintf( file, ",%.4f", profiler.samples[i][s] * 1000.0 );
+            } else {
+                fprintf( file, "," );
+            }
+        }
+        fprintf( file, "\n" );
+    }
+
+    pthread_mutex_unlock( &profilerMutex );
+
+    fclose( file );
+
+    return true;
+
+}
+
+static int compareSamples( const void *a, const void *b ) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return ( x > y ) - ( x < y );
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ * @file Random.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Random implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdint.h>
+
+#include "Random.h"
+
+Random createRandom( uint64_t seed ) {
+
+    // splitmix64
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+    z = z ^ ( z >> 31 );
+
+    // xorshift can't leave the zero state
+    return (Random) {
+        .state = z != 0 ? z : 0x9E3779B97F4A7C15ull
+    };
+
+}
+
+uint64_t nextRandom( Random *random ) {
+
+    uint64_t x = random->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    random->state = x;
+
+    return x * 0x2545F4914F6CDD1Dull;
+
+}
+
+float nextFloatRandom( Random *random, float min, float max ) {
+    // the 24 high bits fill the float mantissa exactly
+    float unit = ( nextRandom( random ) >> 40 ) * ( 1.0f / 16777216.0f );
+    return min + ( max - min ) * unit;
+}
+
+void fillFloatRandom( Random *random, float *values, int quantity, float min, float max ) {
+
+    float range = ( max - min ) * ( 1.0f / 16777216.0f );
+    int i = 0;
+
+    // two floats per 64 bit draw
+    for ( ; i + 2 <= quantity; i += 2 ) {
+        uint64_t bits = nextRandom( random );
+        values[i] = min + range * (float) ( bits >> 40 );
+        values[i+1] = min + range * (float) ( ( bits >> 8 ) & 0xFFFFFF );
+    }
+
+    if ( i < quantity ) {
+        values[i] = min + range * (float) ( nextRandom( random ) >> 40 );
+    }
+
+}
+
+void flipSignRandom( Random *random, float *values, int quantity ) {
+
+    uint64_t bits = 0;
+
+    for ( int i = 0; i < quantity; i++ ) {
+        if ( i % 64 == 0 ) {
+            bits = nextRandom( random );
+        }
+        if ( bits & 1 ) {
+            values[i] = -values[i];
+        }
+        bits >>= 1;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/**
+ * @file RenderSnapshot.c
+ * @author Prof. Dr. David Buzatto
+ * @brief RenderSnapshot implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "RenderSnapshot.h"
+#include "GameWorld.h"
+#include "Particle.h"
+#include "ParticleEmitter.h"
+#include "ObstacleLoader.h"
+#include "raylib/raylib.h"
+
+static void captureEmitters( RenderSnapshot *rs, GameWorld *gw );
+static void captureObstacles( RenderSnapshot *rs, GameWorld *gw );
+
+RenderSnapshot createRenderSnapshot( void ) {
+    return (RenderSnapshot) { 0 };
+}
+
+void destroyRenderSnapshot( RenderSnapshot *rs ) {
+    for ( int k = 0; k < rs->emittersQuantity; k++ ) {
+        destroyParticleStore( &rs->emitters[k].particles );
+    }
+    free( rs->emitters );
+    free( rs->obstacles );
+    *rs = createRenderSnapshot();
+}
+
+void captureRenderSnapshot( RenderSnapshot *rs, GameWorld *gw, double time ) {
+
+    rs->time = time;
+    rs->fixedDelta = gw->fixedDelta;
+    rs->camera = gw->camera;
+
+    captureEmitters( rs, gw );
+    captureObstacles( rs, gw );
+
+    rs->useTileMap = gw->useTileMap;
+    rs->tileQuantity = gw->useTileMap ? gw->tileMap.solidQuantity : 0;
+    rs->totalObstacles = gw->obstacleQuantity;
+    rs->loadingObstacles = isBusyObstacleLoader( gw->obstacleLoader );
+
+}
+
+/**
+ * @brief The emitters are copied whole, but their stores are the ones of
+ * the snapshot, sized like the world ones the first time.
+ */
+static void captureEmitters( RenderSnapshot *rs, GameWorld *gw ) {
+
+    if ( rs->emitters == NULL ) {
+        rs->emittersQuantity = gw->emittersQuantity;
+        rs->emitters = (ParticleEmitter*) calloc( rs->emittersQuantity, sizeof( ParticleEmitter ) );
+        for ( int k = 0; k < rs->emittersQuantity; k++ ) {
+            rs->emitters[k].particles = createParticleStore( gw->emitters[k]->particles.capacity );
+        }
+    }
+
+    for ( int k = 0; k < rs->emittersQuantity; k++ ) {
+
+        ParticleStore store = rs->emitters[k].particles;
+        ParticleStore *ps = &gw->emitters[k]->particles;
+        int n = ps->quantity;
+
+        rs->emitters[k] = *gw->emitters[k];
+        rs->emitters[k].particles = store;
+
+        memcpy( store.x, ps->x, n * sizeof( float ) );
+        memcpy( store.y, ps->y, n * sizeof( float ) );
+        memcpy( store.prevX, ps->prevX, n * sizeof( float ) );
+        memcpy( store.prevY, ps->prevY, n * sizeof( float ) );
+        memcpy( store.radius, ps->radius, n * sizeof( float ) );
+        memcpy( store.color, ps->color, n * sizeof( Color ) );
+        rs->emitters[k].particles.quantity = n;
+        rs->emitters[k].particles.awake = ps->awake;
+
+    }
+
+}
+
+/**
+ * @brief The visible obstacles are only collected again when the world
+ * says the obstacle layer changed since this snapshot was filled.
+ */
+static void captureObstacles( RenderSnapshot *rs, GameWorld *gw ) {
+
+    unsigned int version = updateObstacleLayerGameWorld( gw );
+
+    if ( rs->obstacleVersion == version ) {
+        return;
+    }
+
+    rs->obstacleView = gw->obstacleLayerView;
+    rs->obstacleQuantity = getVisibleObstaclesGameWorld( gw, rs->obstacleView, rs->obstacles, rs->obstacleCapacity );
+
+    if ( rs->obstacleQuantity > rs->obstacleCapacity ) {
+        rs->obstacleCapacity = rs->obstacleQuantity;
+        rs->obstacles = (Rectangle*) realloc( rs->obstacles, rs->obstacleCapacity * sizeof( Rectangle ) );
+        getVisibleObstaclesGameWorld( gw, rs->obstacleView, rs->obstacles, rs->obstacleCapacity );
+    }
+
+    rs->obstacleVersion = version;
+
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+/**
+ * @file SimulationThread.c
+ * @author Prof. Dr. David Buzatto
+ * @brief SimulationThread implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "SimulationThread.h"
+#include "GameInput.h"
+#include "GameWorld.h"
+#include "Platform.h"
+#include "RenderSnapshot.h"
+#include "Trace.h"
+
+// set in the shared index when it holds a snapshot not taken yet
+#define SNAPSHOT_NEW 4
+
+struct SimulationThread {
+
+    GameWorld *gw;
+    pthread_t thread;
+    int stopping;
+
+    // producer side input that didn't fit in the queue yet
+    GameInputQueue inputs;
+    GameInput unsent;
+    bool hasUnsent;
+
+    // triple buffer: the simulation fills back, drawing reads front and
+    // they trade with middle (an index, possibly flagged SNAPSHOT_NEW)
+    RenderSnapshot snapshots[3];
+    int back;
+    int middle;
+    int front;
+
+};
+
+static void *runSimulation( void *arg );
+static void publishSnapshot( SimulationThread *st, double time );
+
+SimulationThread *createSimulationThread( GameWorld *gw ) {
+
+    SimulationThread *st = (SimulationThread*) calloc( 1, sizeof( SimulationThread ) );
+
+    st->gw = gw;
+    st->front = 0;
+    st->middle = 1;
+    st->back = 2;
+
+    for ( int i = 0; i < 3; i++ ) {
+        st->snapshots[i] = createRenderSnapshot();
+    }
+
+    publishSnapshot( st, getTimePlatform() );
+    getSnapshotSimulationThread( st );
+
+    if ( pthread_create( &st->thread, NULL, runSimulation, st ) != 0 ) {
+        for ( int i = 0; i < 3; i++ ) {
+            destroyRenderSnapshot( &st->snapshots[i] );
+        }
+        free( st );
+        return NULL;
+    }
+
+    return st;
+
+}
+
+void destroySimulationThread( SimulationThread *st ) {
+
+    __atomic_store_n( &st->stopping, 1, __ATOMIC_RELEASE );
+    pthread_join( st->thread, NULL );
+
+    for ( int i = 0; i < 3; i++ ) {
+        destroyRenderSnapshot( &st->snapshots[i] );
+    }
+
+    free( st );
+
+}
+
+void pushInputSimulationThread( SimulationThread *st, const GameInput *input ) {
+
+    if ( st->hasUnsent ) {
+        mergeGameInput( &st->unsent, input );
+    } else {
+        st->unsent = *input;
+    }
+
+    st->hasUnsent = !pushGameInputQueue( &st->inputs, &st->unsent );
+
+}
+
+RenderSnapshot *getSnapshotSimulationThread( SimulationThread *st ) {
+
+    if ( __atomic_load_n( &st->middle, __ATOMIC_ACQUIRE ) & SNAPSHOT_NEW ) {
+        st->front = __atomic_exchange_n( &st->middle, st->front, __ATOMIC_ACQ_REL ) & ~SNAPSHOT_NEW;
+    }
+
+    return &st->snapshots[st->front];
+
+}
+
+/**
+ * @brief Steps the world when the accumulated time asks for it and sleeps
+ * until the next step is due. Nothing runs before the first input, which
+ * brings the screen size.
+ */
+static void *runSimulation( void *arg ) {
+
+    SimulationThread *st = (SimulationThread*) arg;
+    GameWorld *gw = st->gw;
+    GameInput input = { 0 };
+    bool hasInput = false;
+    double last = getTimePlatform();
+
+    setThreadTrace( TRACE_SIMULATION_THREAD );
+
+    while ( !__atomic_load_n( &st->stopping, __ATOMIC_ACQUIRE ) ) {
+
+        GameInput received;
+        while ( popGameInputQueue( &st->inputs, &received ) ) {
+            mergeGameInput( &input, &received );
+            hasInput = true;
+        }
+
+        double now = getTimePlatform();
+        input.delta = (float) ( now - last );
+        last = now;
+
+        if ( !hasInput ) {
+            sleepPlatform( 0.001 );
+            continue;
+        }
+
+        // the world keeps the events until a step consumes them
+        int steps = advanceGameWorld( gw, &input );
+        clearEventsGameInput( &input );
+
+        if ( steps > 0 ) {
+            publishSnapshot( st, now - gw->accumulator );
+        }
+
+        sleepPlatform( gw->fixedDelta - gw->accumulator );
+
+    }
+
+    return NULL;
+
+}
+
+static void publishSnapshot( SimulationThread *st, double time ) {
+    double start = beginTraceZone();
+    captureRenderSnapshot( &st->snapshots[st->back], st->gw, time );
+    st->back = __atomic_exchange_n( &st->middle, st->back | SNAPSHOT_NEW, __ATOMIC_ACQ_REL ) & ~SNAPSHOT_NEW;
+    endTraceZone( "snapshot", start );
+}
\ No newline at end of file
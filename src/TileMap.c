@@ -0,0 +1,222 @@
+/**
+ * @file TileMap.c
+ * @author Prof. Dr. David Buzatto
+ * @brief TileMap implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "TileMap.h"
+#include "Obstacle.h"
+#include "raylib/raylib.h"
+
+static void resetBounds( TileMap *tm );
+
+TileMap createTileMap( float tileSize, float originX, float originY, int columns, int rows ) {
+
+    TileMap tm = {
+        .tileSize = tileSize,
+        .originX = originX,
+        .originY = originY,
+        .columns = columns,
+        .rows = rows,
+        .tiles = (unsigned char*) calloc( (size_t) columns * rows, sizeof( unsigned char ) ),
+        .solidQuantity = 0
+    };
+
+    resetBounds( &tm );
+
+    return tm;
+
+}
+
+void destroyTileMap( TileMap *tm ) {
+    free( tm->tiles );
+    memset( tm, 0, sizeof( TileMap ) );
+}
+
+void clearTileMap( TileMap *tm ) {
+    memset( tm->tiles, 0, (size_t) tm->columns * tm->rows );
+    tm->solidQuantity = 0;
+    resetBounds( tm );
+}
+
+bool isSolidTileMap( TileMap *tm, int column, int row ) {
+    return column >= 0 && row >= 0 && column < tm->columns && row < tm->rows &&
+           tm->tiles[row * tm->columns + column] != 0;
+}
+
+void updateBoundsTileMap( TileMap *tm ) {
+
+    tm->solidQuantity = 0;
+    resetBounds( tm );
+
+    for ( int r = 0; r < tm->rows; r++ ) {
+        for ( int c = 0; c < tm->columns; c++ ) {
+            if ( tm->tiles[r * tm->columns + c] != 0 ) {
+                tm->solidQuantity++;
+                tm->firstColumn = c < tm->firstColumn ? c : tm->firstColumn;
+                tm->firstRow = r < tm->firstRow ? r : tm->firstRow;
+                tm->lastColumn = c > tm->lastColumn ? c : tm->lastColumn;
+                tm->lastRow = r > tm->lastRow ? r : tm->lastRow;
+            }
+        }
+    }
+
+}
+
+void fillTileMap( TileMap *tm, Rectangle rect ) {
+
+    // tiles whose center is inside rect
+    int c0 = (int) ceilf( ( rect.x - tm->originX ) / tm->tileSize - 0.5f );
+    int r0 = (int) ceilf( ( rect.y - tm->originY ) / tm->tileSize - 0.5f );
+    int c1 = (int) floorf( ( rect.x + rect.width - tm->originX ) / tm->tileSize - 0.5f );
+    int r1 = (int) floorf( ( rect.y + rect.height - tm->originY ) / tm->tileSize - 0.5f );
+
+    c0 = c0 < 0 ? 0 : c0;
+    r0 = r0 < 0 ? 0 : r0;
+    c1 = c1 >= tm->columns ? tm->columns - 1 : c1;
+    r1 = r1 >= tm->rows ? tm->rows - 1 : r1;
+
+    for ( int r = r0; r <= r1; r++ ) {
+        for ( int c = c0; c <= c1; c++ ) {
+
+            unsigned char *tile = &tm->tiles[r * tm->columns + c];
+
+            if ( *tile == 0 ) {
+                *tile = 1;
+                tm->solidQuantity++;
+            }
+
+        }
+    }
+
+    if ( c0 <= c1 && r0 <= r1 ) {
+        tm->firstColumn = c0 < tm->firstColumn ? c0 : tm->firstColumn;
+        tm->firstRow = r0 < tm->firstRow ? r0 : tm->firstRow;
+        tm->lastColumn = c1 > tm->lastColumn ? c1 : tm->lastColumn;
+        tm->lastRow = r1 > tm->lastRow ? r1 : tm->lastRow;
+    }
+
+}
+
+void rasterizeObstaclesTileMap( TileMap *tm, Obstacle *obstacles, int obstacleQuantity ) {
+    clearTileMap( tm );
+    for ( int i = 0; i < obstacleQuantity; i++ ) {
+        fillTileMap( tm, obstacles[i].rect );
+    }
+}
+
+int getRunsTileMap( TileMap *tm, Rectangle *runs, int capacity ) {
+
+    int quantity = 0;
+
+    for ( int r = tm->firstRow; r <= tm->lastRow; r++ ) {
+
+        unsigned char *row = &tm->tiles[r * tm->columns];
+
+        for ( int c = tm->firstColumn; c <= tm->lastColumn; c++ ) {
+
+            if ( row[c] == 0 ) {
+                continue;
+            }
+
+            int start = c;
+            while ( c + 1 <= tm->lastColumn && row[c + 1] != 0 ) {
+                c++;
+            }
+
+            if ( quantity < capacity ) {
+                runs[quantity] = (Rectangle) {
+                    tm->originX + start * tm->tileSize,
+                    tm->originY + r * tm->tileSize,
+                    ( c - start + 1 ) * tm->tileSize,
+                    tm->tileSize
+                };
+            }
+
+            quantity++;
+
+        }
+
+    }
+
+    return quantity;
+
+}
+
+bool getBoundsTileMap( TileMap *tm, Rectangle *bounds ) {
+
+    if ( tm->solidQuantity == 0 ) {
+        return false;
+    }
+
+    *bounds = (Rectangle) {
+        tm->originX + tm->firstColumn * tm->tileSize,
+        tm->originY + tm->firstRow * tm->tileSize,
+        ( tm->lastColumn - tm->firstColumn + 1 ) * tm->tileSize,
+        ( tm->lastRow - tm->firstRow + 1 ) * tm->tileSize
+    };
+
+    return true;
+
+}
+
+int getViewRunsTileMap( TileMap *tm, Rectangle view, Rectangle *runs, int capacity ) {
+
+    int quantity = 0;
+
+    int c0 = (int) floorf( ( view.x - tm->originX ) / tm->tileSize );
+    int r0 = (int) floorf( ( view.y - tm->originY ) / tm->tileSize );
+    int c1 = (int) floorf( ( view.x + view.width - tm->originX ) / tm->tileSize );
+    int r1 = (int) floorf( ( view.y + view.height - tm->originY ) / tm->tileSize );
+
+    c0 = c0 < tm->firstColumn ? tm->firstColumn : c0;
+    r0 = r0 < tm->firstRow ? tm->firstRow : r0;
+    c1 = c1 > tm->lastColumn ? tm->lastColumn : c1;
+    r1 = r1 > tm->lastRow ? tm->lastRow : r1;
+
+    for ( int r = r0; r <= r1; r++ ) {
+
+        unsigned char *row = &tm->tiles[r * tm->columns];
+
+        for ( int c = c0; c <= c1; c++ ) {
+
+            if ( row[c] == 0 ) {
+                continue;
+            }
+
+            int start = c;
+            while ( c + 1 <= c1 && row[c + 1] != 0 ) {
+                c++;
+            }
+
+            if ( quantity < capacity ) {
+                runs[quantity] = (Rectangle) {
+                    tm->originX + start * tm->tileSize,
+                    tm->originY + r * tm->tileSize,
+                    ( c - start + 1 ) * tm->tileSize,
+                    tm->tileSize
+                };
+            }
+
+            quantity++;
+
+        }
+
+    }
+
+    return quantity;
+
+}
+
+static void resetBounds( TileMap *tm ) {
+    tm->firstColumn = tm->columns;
+    tm->firstRow = tm->rows;
+    tm->lastColumn = -1;
+    tm->lastRow = -1;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/**
+ * @file Trace.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Trace implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "Trace.h"
+#include "Platform.h"
+
+#define TRACE_EVENT_CAPACITY ( 1 << 18 )
+
+Trace trace = { 0 };
+
+// the events can't be freed while another thread appends to them
+static pthread_mutex_t traceMutex = PTHREAD_MUTEX_INITIALIZER;
+static __thread int currentThread = TRACE_MAIN_THREAD;
+
+static void writeTrace( void );
+static const char *getThreadName( int thread, char *buffer, int size );
+
+void startTrace( const char *fileName, int frameQuantity ) {
+
+    if ( frameQuantity <= 0 ) {
+        return;
+    }
+
+    pthread_mutex_lock( &traceMutex );
+
+    if ( trace.active ) {
+        pthread_mutex_unlock( &traceMutex );
+        return;
+    }
+
+    if ( trace.events == NULL ) {
+        trace.events = (TraceEvent*) malloc( TRACE_EVENT_CAPACITY * sizeof( TraceEvent ) );
+        trace.eventCapacity = TRACE_EVENT_CAPACITY;
+    }
+
+    trace.fileName = fileName;
+    trace.remainingFrames = frameQuantity;
+    trace.eventQuantity = 0;
+    trace.origin = getTimePlatform();
+    trace.frameStart = trace.origin;
+    __atomic_store_n( &trace.active, trace.events != NULL, __ATOMIC_RELEASE );
+
+    pthread_mutex_unlock( &traceMutex );
+
+}
+
+void stopTrace( void ) {
+
+    pthread_mutex_lock( &traceMutex );
+
+    if ( trace.active ) {
+        __atomic_store_n( &trace.active, false, __ATOMIC_RELEASE );
+        writeTrace();
+    }
+
+    free( trace.events );
+    trace.events = NULL;
+    trace.eventCapacity = 0;
+
+    pthread_mutex_unlock( &traceMutex );
+
+}
+
+double beginTraceZone( void ) {
+    return __atomic_load_n( &trace.active, __ATOMIC_ACQUIRE ) ? getTimePlatform() : 0.0;
+}
+
+void endTraceZone( const char *name, double start ) {
+
+    if ( !__atomic_load_n( &trace.active, __ATOMIC_ACQUIRE ) ) {
+        return;
+    }
+
+    double end = getTimePlatform();
+
+    pthread_mutex_lock( &traceMutex );
+
+    // zones that began before the trace started are left out
+    if ( trace.active && start >= trace.origin ) {
+        int index = trace.eventQuantity++;
+        if ( index < trace.eventCapacity ) {
+            trace.events[index] = (TraceEvent) { name, currentThread, start, end };
+        }
+    }
+
+    pthread_mutex_unlock( &traceMutex );
+
+}
+
+void setThreadTrace( int thread ) {
+    currentThread = thread;
+}
+
+void endFrameTrace( void ) {
+
+    if ( !__atomic_load_n( &trace.active, __ATOMIC_ACQUIRE ) ) {
+        return;
+    }
+
+    endTraceZone( "frame", trace.frameStart );
+    trace.frameStart = getTimePlatform();
+
+    if ( --trace.remainingFrames == 0 ) {
+        stopTrace();
+    }
+
+}
+
+static void writeTrace( void ) {
+
+    FILE *file = fopen( trace.fileName, "w" );
+
+    if ( file == NULL ) {
+        return;
+    }
+
+    int quantity = trace.eventQuantity < trace.eventCapacity ? trace.eventQuantity : trace.eventCapacity;
+    int maxThread = 0;
+    char name[32];
+
+    fprintf( file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+    for ( int i = 0; i < quantity; i++ ) {
+        TraceEvent *e = &trace.events[i];
+        fprintf( 
+            file, 
+            "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+            e->name, e->thread,
+            ( e->start - trace.origin ) * 1e6,
+            ( e->end - e->start ) * 1e6
+        );
+        if ( e->thread > maxThread ) {
+            maxThread = e->thread;
+        }
+    }
+
+    for ( int i = 0; i <= maxThread; i++ ) {
+        fprintf( 
+            file, 
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", 
+            i == 0 ? "" : ",\n", i, getThreadName( i, name, sizeof( name ) )
+        );
+    }
+
+    fprintf( file, "\n]}\n" );
+    fclose( file );
+
+    if ( trace.eventQuantity > trace.eventCapacity ) {
+        fprintf( stderr, "trace: %d events dropped\n", trace.eventQuantity - trace.eventCapacity );
+    }
+
+}
+
+static const char *getThreadName( int thread, char *buffer, int size ) {
+    if ( thread == TRACE_MAIN_THREAD ) {
+        return "main";
+    } else if ( thread == TRACE_SIMULATION_THREAD ) {
+        return "simulation";
+    }
+    snprintf( buffer, size, "worker %d", thread - TRACE_WORKER_THREAD + 1 );
+    return buffer;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+/**
+ * @file WorkerPool.c
+ * @author Prof. Dr. David Buzatto
+ * @brief WorkerPool implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "WorkerPool.h"
+#include "Trace.h"
+
+typedef struct Worker {
+    WorkerPool *pool;
+    int index;
+    pthread_t thread;
+} Worker;
+
+struct WorkerPool {
+
+    int workerQuantity;
+    Worker *workers;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t jobAvailable;
+    pthread_cond_t jobDone;
+
+    // a new job is published by incrementing generation
+    unsigned long generation;
+    bool stop;
+
+    WorkerTask task;
+    void *context;
+    int itemQuantity;
+    int parts;
+    int pendingParts;
+
+};
+
+static void *runWorker( void *arg );
+static void runPart( WorkerPool *pool, int part );
+
+/**
+ * @brief Creates a pool with workerQuantity extra threads. The thread
+ * that runs the jobs also works, so the pool uses workerQuantity + 1 cores.
+ */
+WorkerPool *createWorkerPool( int workerQuantity ) {
+
+    WorkerPool *pool = (WorkerPool*) calloc( 1, sizeof( WorkerPool ) );
+
+    pthread_mutex_init( &pool->mutex, NULL );
+    pthread_cond_init( &pool->jobAvailable, NULL );
+    pthread_cond_init( &pool->jobDone, NULL );
+
+    pool->workers = (Worker*) calloc( workerQuantity > 0 ? workerQuantity : 1, sizeof( Worker ) );
+
+    for ( int i = 0; i < workerQuantity; i++ ) {
+        Worker *w = &pool->workers[pool->workerQuantity];
+        w->pool = pool;
+        w->index = pool->workerQuantity;
+        if ( pthread_create( &w->thread, NULL, runWorker, w ) == 0 ) {
+            pool->workerQuantity++;
+        }
+    }
+
+    return pool;
+
+}
+
+/**
+ * @brief Stops and joins the threads and destroys the pool.
+ */
+void destroyWorkerPool( WorkerPool *pool ) {
+
+    pthread_mutex_lock( &pool->mutex );
+    pool->stop = true;
+    pthread_cond_broadcast( &pool->jobAvailable );
+    pthread_mutex_unlock( &pool->mutex );
+
+    for ( int i = 0; i < pool->workerQuantity; i++ ) {
+        pthread_join( pool->workers[i].thread, NULL );
+    }
+
+    pthread_cond_destroy( &pool->jobDone );
+    pthread_cond_destroy( &pool->jobAvailable );
+    pthread_mutex_destroy( &pool->mutex );
+
+    free( pool->workers );
+    free( pool );
+
+}
+
+/**
+ * @brief Splits [0, itemQuantity) in contiguous slices of at least
+ * minItemsPerPart items, runs task over them in parallel and waits for all
+ * of them to finish. Small jobs run on the calling thread only.
+ */
+void runWorkerPool( WorkerPool *pool, WorkerTask task, void *context, int itemQuantity, int minItemsPerPart ) {
+
+    if ( itemQuantity <= 0 ) {
+        return;
+    }
+
+    int parts = pool->workerQuantity + 1;
+    if ( minItemsPerPart > 0 && itemQuantity / minItemsPerPart < parts ) {
+        parts = itemQuantity / minItemsPerPart;
+    }
+
+    if ( parts <= 1 ) {
+        task( context, 0, itemQuantity, 0 );
+        return;
+    }
+
+    pthread_mutex_lock( &pool->mutex );
+    pool->task = task;
+    pool->context = context;
+    pool->itemQuantity = itemQuantity;
+    pool->parts = parts;
+    pool->pendingParts = parts - 1;
+    pool->generation++;
+    pthread_cond_broadcast( &pool->jobAvailable );
+    pthread_mutex_unlock( &pool->mutex );
+
+    runPart( pool, 0 );
+
+    pthread_mutex_lock( &pool->mutex );
+    while ( pool->pendingParts > 0 ) {
+        pthread_cond_wait( &pool->jobDone, &pool->mutex );
+    }
+    pthread_mutex_unlock( &pool->mutex );
+
+}
+
+/**
+ * @brief Number of threads (the calling one included) that take part in
+ * the jobs.
+ */
+int getThreadQuantityWorkerPool( WorkerPool *pool ) {
+    return pool->workerQuantity + 1;
+}
+
+/**
+ * @brief Worker i runs part i + 1 of every job that has that many parts.
+ */
+static void *runWorker( void *arg ) {
+
+    Worker *w = (Worker*) arg;
+    WorkerPool *pool = w->pool;
+    unsigned long seenGeneration = 0;
+
+    setThreadTrace( TRACE_WORKER_THREAD + w->index );
+
+    pthread_mutex_lock( &pool->mutex );
+
+    while ( true ) {
+
+        while ( !pool->stop && pool->generation == seenGeneration ) {
+            pthread_cond_wait( &pool->jobAvailable, &pool->mutex );
+        }
+
+        if ( pool->stop ) {
+            break;
+        }
+
+        seenGeneration = pool->generation;
+        int part = w->index + 1;
+
+        if ( part < pool->parts ) {
+
+            pthread_mutex_unlock( &pool->mutex );
+            runPart( pool, part );
+            pthread_mutex_lock( &pool->mutex );
+
+            if ( --pool->pendingParts == 0 ) {
+                pthread_cond_signal( &pool->jobDone );
+            }
+
+        }
+
+    }
+
+    pthread_mutex_unlock( &pool->mutex );
+
+    return NULL;
+
+}
+
+static void runPart( WorkerPool *pool, int part ) {
+    int start = (int) ( (long long) pool->itemQuantity * part / pool->parts );
+    int end = (int) ( (long long) pool->itemQuantity * ( part + 1 ) / pool->parts );
+    pool->task( pool->context, start, end, part );
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+/**
+ * @file WorldFile.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Binary world snapshot implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "WorldFile.h"
+#include "GameWorld.h"
+#include "Obstacle.h"
+#include "Particle.h"
+#include "ParticleEmitter.h"
+#include "Platform.h"
+#include "TileMap.h"
+#include "raylib/raylib.h"
+
+#define PARTICLE_ARRAYS 12
+#define PARTICLE_BYTES ( 11 * sizeof( float ) + sizeof( Color ) )
+
+static void getParticleArrays( ParticleStore *ps, void **arrays, size_t *sizes );
+
+bool saveWorldFile( GameWorld *gw, const char *fileName ) {
+
+    FILE *file = fopen( fileName, "wb" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    TileMap *tm = &gw->tileMap;
+
+    WorldFileHeader header = {
+        .magic = WORLD_FILE_MAGIC,
+        .version = WORLD_FILE_VERSION,
+        .seed = gw->seed,
+        .width = gw->width,
+        .height = gw->height,
+        .camera = gw->camera,
+        .emittersQuantity = gw->emittersQuantity,
+        .obstacleSize = (int32_t) sizeof( Obstacle ),
+        .maxObstacles = gw->maxObstacles,
+        .obstacleQuantity = gw->obstacleQuantity,
+        .newObstaclePos = gw->newObstaclePos,
+        .obstacleCounter = gw->obstacleCounter,
+        .paintingObstacles = gw->paintingObstacles,
+        .useTileMap = gw->useTileMap,
+        .tileSize = gw->tileSize,
+        .tileOriginX = tm->originX,
+        .tileOriginY = tm->originY,
+        .tileColumns = gw->useTileMap ? tm->columns : 0,
+        .tileRows = gw->useTileMap ? tm->rows : 0
+    };
+
+    bool ok = fwrite( &header, sizeof( header ), 1, file ) == 1;
+
+    for ( int k = 0; k < gw->emittersQuantity && ok; k++ ) {
+
+        ParticleEmitter *pe = gw->emitters[k];
+        ParticleStore *ps = &pe->particles;
+
+        WorldFileEmitter e = {
+            .pos = pe->pos,
+            .vel = pe->vel,
+            .launchAngle = pe->launchAngle,
+            .posAngle = pe->posAngle,
+            .posAngleVel = pe->posAngleVel,
+            .hueAngle = pe->hueAngle,
+            .hueAngleVel = pe->hueAngleVel,
+            .radius = pe->radius,
+            .dragging = pe->dragging,
+            .emissionCarry = pe->emissionCarry,
+            .newParticlePos = pe->newParticlePos,
+            .random = pe->random.state,
+            .quantity = ps->quantity,
+            .capacity = ps->capacity,
+            .awake = ps->awake,
+            .lifetime = ps->lifetime,
+            .friction = ps->friction,
+            .elasticity = ps->elasticity
+        };
+
+        void *arrays[PARTICLE_ARRAYS];
+        size_t sizes[PARTICLE_ARRAYS];
+        getParticleArrays( ps, arrays, sizes );
+
+        ok = fwrite( &e, sizeof( e ), 1, file ) == 1;
+
+        for ( int a = 0; a < PARTICLE_ARRAYS && ok; a++ ) {
+            ok = fwrite( arrays[a], sizes[a], ps->quantity, file ) == (size_t) ps->quantity;
+        }
+
+    }
+
+    ok = ok && fwrite( gw->obstacles, sizeof( Obstacle ), gw->obstacleQuantity, file ) == (size_t) gw->obstacleQuantity;
+
+    if ( gw->useTileMap ) {
+        size_t tiles = (size_t) tm->columns * tm->rows;
+        ok = ok && fwrite( tm->tiles, 1, tiles, file ) == tiles;
+    }
+
+    ok = fclose( file ) == 0 && ok;
+
+    return ok;
+
+}
+
+bool loadWorldFile( GameWorld *gw, const char *fileName ) {
+
+    long long size;
+    const char *data = (const char*) mapFilePlatform( fileName, &size );
+
+    if ( data == NULL ) {
+        return false;
+    }
+
+    // the snapshot is checked as a whole before the world is touched
+    WorldFileHeader header;
+    bool valid = size >= (long long) sizeof( header );
+
+    if ( valid ) {
+        memcpy( &header, data, sizeof( header ) );
+        valid = header.magic == WORLD_FILE_MAGIC &&
+                header.version == WORLD_FILE_VERSION &&
+                header.width > 0 &&
+                header.height > 0 &&
+                header.emittersQuantity == gw->emittersQuantity &&
+                header.obstacleSize == (int32_t) sizeof( Obstacle ) &&
+                header.maxObstacles > 0 &&
+                header.maxObstacles <= MAX_OBSTACLES &&
+                header.obstacleQuantity >= 0 &&
+                header.obstacleQuantity <= header.maxObstacles &&
+                header.newObstaclePos >= 0 &&
+                ( !header.useTileMap || ( header.tileSize > 0.0f && header.tileColumns > 0 && header.tileRows > 0 ) );
+    }
+
+    // emitters aren't aligned in the file, so they are copied out
+    WorldFileEmitter *emitters = (WorldFileEmitter*) malloc( gw->emittersQuantity * sizeof( WorldFileEmitter ) );
+    long long *particleData = (long long*) malloc( gw->emittersQuantity * sizeof( long long ) );
+    long long offset = sizeof( header );
+
+    for ( int k = 0; k < gw->emittersQuantity && valid; k++ ) {
+        valid = offset + (long long) sizeof( WorldFileEmitter ) <= size;
+        if ( valid ) {
+            memcpy( &emitters[k], data + offset, sizeof( WorldFileEmitter ) );
+            // the render snapshots and the renderer are sized after the
+            // stores, so they can't change size
+            valid = emitters[k].capacity == gw->emitters[k]->particles.capacity &&
+                    emitters[k].quantity >= 0 && emitters[k].quantity <= emitters[k].capacity &&
+                    emitters[k].awake >= 0 && emitters[k].awake <= emitters[k].quantity &&
+                    emitters[k].newParticlePos >= 0;
+            offset += sizeof( WorldFileEmitter );
+            particleData[k] = offset;
+            offset += (long long) emitters[k].quantity * PARTICLE_BYTES;
+        }
+    }
+
+    long long obstacleData = offset;
+    offset += (long long) header.obstacleQuantity * sizeof( Obstacle );
+    long long tileData = offset;
+    offset += header.useTileMap ? (long long) header.tileColumns * header.tileRows : 0;
+
+    // a new obstacle array is allocated before the world changes, so
+    // running out of memory leaves it as it was
+    Obstacle *obstacles = gw->obstacles;
+
+    if ( valid && offset == size && header.maxObstacles != gw->maxObstacles ) {
+        obstacles = (Obstacle*) malloc( (size_t) header.maxObstacles * sizeof( Obstacle ) );
+        valid = obstacles != NULL;
+    }
+
+    if ( !valid || offset != size ) {
+        if ( obstacles != gw->obstacles ) {
+            free( obstacles );
+        }
+        free( emitters );
+        free( particleData );
+        unmapFilePlatform( data, size );
+        return false;
+    }
+
+    gw->seed = header.seed;
+    gw->width = header.width;
+    gw->height = header.height;
+    gw->camera = header.camera;
+
+    for ( int k = 0; k < gw->emittersQuantity; k++ ) {
+
+        ParticleEmitter *pe = gw->emitters[k];
+        ParticleStore *ps = &pe->particles;
+        WorldFileEmitter *e = &emitters[k];
+
+        pe->pos = e->pos;
+        pe->vel = e->vel;
+        pe->launchAngle = e->launchAngle;
+        pe->posAngle = e->posAngle;
+        pe->posAngleVel = e->posAngleVel;
+        pe->hueAngle = e->hueAngle;
+        pe->hueAngleVel = e->hueAngleVel;
+        pe->radius = e->radius;
+        pe->dragging = e->dragging;
+        pe->mouseOver = false;
+        pe->emissionCarry = e->emissionCarry;
+        pe->newParticlePos = e->newParticlePos;
+        pe->random.state = e->random;
+
+        ps->quantity = e->quantity;
+        ps->awake = e->awake;
+        ps->lifetime = e->lifetime;
+        ps->friction = e->friction;
+        ps->elasticity = e->elasticity;
+
+        void *arrays[PARTICLE_ARRAYS];
+        size_t sizes[PARTICLE_ARRAYS];
+        getParticleArrays( ps, arrays, sizes );
+
+        const char *source = data + particleData[k];
+
+        for ( int a = 0; a < PARTICLE_ARRAYS; a++ ) {
+            memcpy( arrays[a], source, sizes[a] * ps->quantity );
+            source += sizes[a] * ps->quantity;
+        }
+
+    }
+
+    if ( obstacles != gw->obstacles ) {
+        free( gw->obstacles );
+        gw->obstacles = obstacles;
+        gw->maxObstacles = header.maxObstacles;
+    }
+
+    memcpy( gw->obstacles, data + obstacleData, header.obstacleQuantity * sizeof( Obstacle ) );
+    gw->obstacleQuantity = header.obstacleQuantity;
+    gw->newObstaclePos = header.newObstaclePos;
+    gw->obstacleCounter = header.obstacleCounter;
+    gw->paintingObstacles = header.paintingObstacles;
+    gw->obstacleGridDirty = true;
+    gw->obstacleLayerDirty = true;
+
+    destroyTileMap( &gw->tileMap );
+    gw->useTileMap = header.useTileMap;
+    gw->tileSize = header.tileSize;
+
+    if ( gw->useTileMap ) {
+        TileMap *tm = &gw->tileMap;
+        *tm = createTileMap( header.tileSize, header.tileOriginX, header.tileOriginY, header.tileColumns, header.tileRows );
+        memcpy( tm->tiles, data + tileData, (size_t) header.tileColumns * header.tileRows );
+        updateBoundsTileMap( tm );
+    }
+
+    free( emitters );
+    free( particleData );
+    unmapFilePlatform( data, size );
+
+    return true;
+
+}
+
+/**
+ * @brief The particle arrays in file order, with the size of their
+ * elements.
+ */
+static void getParticleArrays( ParticleStore *ps, void **arrays, size_t *sizes ) {
+
+    void *a[PARTICLE_ARRAYS] = { 
+        ps->x, ps->y, ps->prevX, ps->prevY, ps->vx, ps->vy, 
+        ps->radius, ps->color, ps->age, ps->restX, ps->restY, ps->restAge
+    };
+    size_t s[PARTICLE_ARRAYS] = { 
+        sizeof( float ), sizeof( float ), sizeof( float ), sizeof( float ), 
+        sizeof( float ), sizeof( float ), sizeof( float ), sizeof( Color ), 
+        sizeof( float ), sizeof( float ), sizeof( float ), sizeof( float )
+    };
+
+    memcpy( arrays, a, sizeof( a ) );
+    memcpy( sizes, s, sizeof( s ) );
+
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * @file Benchmark.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless benchmark runner declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+typedef struct BenchmarkConfig {
+
+    int steps;
+    float delta;
+    int width;
+    int height;
+    unsigned int seed;
+
+    // threads that update the particles, 0 for one per processor
+    int threadQuantity;
+
+    // emulates mouse painting and emission instead of running without input
+    bool scriptedInput;
+
+    // obstacles loaded before the first step, NULL for none
+    const char *obstaclesFile;
+
+    // tile size of the tile map obstacle backend, 0 for rectangles
+    float tileSize;
+
+    // steps traced from the start (see Trace.h), 0 for none
+    int traceFrames;
+
+    // world snapshot (see WorldFile.h) loaded before the first step and
+    // written after the last one, NULL for none
+    const char *worldFile;
+    const char *savedWorldFile;
+
+    // input recording written while running, NULL for none
+    const char *recordFile;
+
+    // input recording that drives the run, NULL for none: the world is
+    // built as recorded and runs its steps, ignoring steps, width, height,
+    // seed, scriptedInput and tileSize
+    const char *replayFile;
+
+} BenchmarkConfig;
+
+/**
+ * @brief Default configuration: 600 steps of 1/60 s on a 800x450 world,
+ * using every processor.
+ */
+BenchmarkConfig createBenchmarkConfig( void );
+
+/**
+ * @brief Runs the world for config.steps fixed steps without opening a
+ * window and prints the per phase timings and the throughput to stdout.
+ */
+void runBenchmark( BenchmarkConfig config );
\ No newline at end of file
@@ -0,0 +1,21 @@
+/**
+ * @file CollisionBatch.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Batched circle versus rectangle test declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include "raylib/raylib.h"
+
+#define COLLISION_BATCH_SIZE 16
+
+/**
+ * @brief Tests count circles (up to COLLISION_BATCH_SIZE), read from the
+ * x, y and radius arrays, against rect at once. Bit k of the result is set
+ * if circle k touches rect. The arithmetic is the same as the scalar
+ * closest point test, so the bits agree with it exactly.
+ * Uses AVX-512 or AVX when the running CPU supports them, SSE otherwise.
+ */
+unsigned int testRectangleCollisionBatch( const float *x, const float *y, const float *radius, int count, Rectangle rect );
\ No newline at end of file
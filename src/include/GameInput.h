@@ -0,0 +1,99 @@
+/**
+ * @file GameInput.h
+ * @author Prof. Dr. David Buzatto
+ * @brief GameInput struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#define GAME_INPUT_QUEUE_CAPACITY 64
+
+/**
+ * @brief Keyboard actions, combined as bit flags in GameInput.actions.
+ */
+typedef enum GameAction {
+    GAME_ACTION_TOGGLE_INFO      = 1 << 0,
+    GAME_ACTION_SAVE_OBSTACLES   = 1 << 1,
+    GAME_ACTION_LOAD_OBSTACLES   = 1 << 2,
+    GAME_ACTION_RESET_OBSTACLES  = 1 << 3,
+    GAME_ACTION_ZOOM_IN          = 1 << 4,
+    GAME_ACTION_ZOOM_OUT         = 1 << 5,
+    GAME_ACTION_SAVE_PROFILER    = 1 << 6,
+    GAME_ACTION_START_TRACE      = 1 << 7,
+    GAME_ACTION_TOGGLE_TILE_MAP  = 1 << 8,
+    GAME_ACTION_EXPORT_OBSTACLES = 1 << 9,
+    GAME_ACTION_SAVE_WORLD       = 1 << 10,
+    GAME_ACTION_LOAD_WORLD       = 1 << 11
+} GameAction;
+
+/**
+ * @brief Everything the simulation reads from the outside world in one
+ * frame. Filled from raylib by readGameInput or built by hand (headless
+ * runs, scripted input).
+ */
+typedef struct GameInput {
+
+    float delta;
+    int screenWidth;
+    int screenHeight;
+
+    Vector2 mousePos;
+    float mouseWheelMove;
+    bool mouseLeftDown;
+    bool mouseLeftPressed;
+    bool mouseLeftReleased;
+    bool mouseRightDown;
+
+    unsigned int actions;
+
+} GameInput;
+
+/**
+ * @brief Lock free ring that carries inputs from one producer thread to
+ * one consumer thread. Each index is only written by its own side.
+ */
+typedef struct GameInputQueue {
+    GameInput inputs[GAME_INPUT_QUEUE_CAPACITY];
+    unsigned int head;    // next input to pop, written by the consumer
+    unsigned int tail;    // next free slot, written by the producer
+} GameInputQueue;
+
+/**
+ * @brief Polls raylib for the current frame input.
+ */
+GameInput readGameInput( void );
+
+/**
+ * @brief Accumulates a newer input into an older one that wasn't consumed
+ * yet: events (actions, presses, releases, wheel) add up and the held
+ * state, mouse position, screen size and delta take the newer values.
+ */
+void mergeGameInput( GameInput *into, const GameInput *from );
+
+/**
+ * @brief Clears the events of an input after it was consumed, keeping the
+ * held state.
+ */
+void clearEventsGameInput( GameInput *input );
+
+/**
+ * @brief Returns true if the action was triggered in this input.
+ */
+bool hasGameAction( const GameInput *input, GameAction action );
+
+/**
+ * @brief Appends an input to the queue. Returns false, without blocking,
+ * if the queue is full. Producer side only.
+ */
+bool pushGameInputQueue( GameInputQueue *queue, const GameInput *input );
+
+/**
+ * @brief Takes the oldest input of the queue. Returns false, without
+ * blocking, if the queue is empty. Consumer side only.
+ */
+bool popGameInputQueue( GameInputQueue *queue, GameInput *input );
\ No newline at end of file
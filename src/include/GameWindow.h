@@ -27,6 +27,28 @@ typedef struct GameWindow {
     bool loadResources;
     bool initAudio;
 
+    // simulation steps per second, independent of targetFPS
+    float simulationRate;
+    int maxSubsteps;
+
+    // threads that update the particles, 0 for one per processor
+    int threadQuantity;
+
+    // tile size of the tile map obstacle backend, 0 for rectangles
+    float tileSize;
+
+    // frames traced from the start (see Trace.h), 0 for none
+    int traceFrames;
+
+    // world snapshot (see WorldFile.h) loaded before the first step, NULL
+    // for none
+    const char *worldFile;
+
+    // input recording written while running and input recording that
+    // drives the simulation until it ends, NULL for none
+    const char *recordFile;
+    const char *replayFile;
+
     GameWorld *gw;
 
     bool initialized;
@@ -35,6 +57,9 @@ typedef struct GameWindow {
 
 /**
  * @brief Creates a dinamically allocated GameWindow struct instance.
+ * The simulation runs at 60 steps per second, with up to 8 steps per
+ * frame, unless simulationRate and maxSubsteps are changed before
+ * initGameWindow.
  */
 GameWindow* createGameWindow(
         int width, 
@@ -7,13 +7,26 @@
  */
 #pragma once
 
+#include <stdint.h>
+
+#include "GameInput.h"
+#include "InputRecord.h"
 #include "Particle.h"
 #include "ParticleEmitter.h"
+#include "ParticleRenderer.h"
+#include "RenderSnapshot.h"
 #include "Obstacle.h"
+#include "ObstacleGrid.h"
+#include "ObstacleLoader.h"
+#include "ObstacleSet.h"
+#include "TileMap.h"
 
+#include "WorkerPool.h"
 #include "raylib/raylib.h"
 
 extern const float GRAVITY;
+extern const char* TRACE_FILE;
+extern const char* WORLD_FILE;
 
 typedef struct GameWorld {
 
@@ -25,19 +38,89 @@ typedef struct GameWorld {
     int emittersQuantity;
     ParticleEmitter **emitters;
 
+    // what the world was created with, so a recording can build it again
+    uint64_t seed;
+    int width;
+    int height;
+
+    // particle index ranges of the emitters taking the current pass when
+    // seen as a single array: emitter k owns [particleOffsets[k],
+    // particleOffsets[k+1]), which is empty if it already took all of them
+    int *particleOffsets;
+
+    // adaptive substepping: emitter k integrates and collides its particles
+    // in emitterSubsteps[k] passes of delta / emitterSubsteps[k], enough to
+    // keep the fastest one under MAX_STEP_DISPLACEMENT per pass
+    int *emitterSubsteps;
+
+    // previous positions of the particles of the substepped emitters at the
+    // start of the step, put back after the last pass for drawing
+    int stepStartCapacity;
+    float *stepStartX;
+    float *stepStartY;
+
+    // particles removed by age or by leaving the world in the last step
+    int removedParticles;
+
+    // splits particle integration and collision among the cores
+    WorkerPool *workerPool;
+
     int newObstaclePos;
+    float obstacleCounter;    // painting time since the last obstacle
     int obstacleQuantity;
     int maxObstacles;
     Obstacle *obstacles;
 
+    // broad phase, rebuilt before the next collision pass when dirty
+    ObstacleGrid obstacleGrid;
+    bool obstacleGridDirty;
+
+    // F6 loads on a background thread, the new set is swapped in at the
+    // start of a frame
+    ObstacleLoader *obstacleLoader;
+
+    // the painted obstacles are merged when the right button is released
+    bool paintingObstacles;
+
+    // optional obstacle backend: when useTileMap is true the obstacles
+    // live in tileMap and the rectangles above are only kept for saving
+    bool useTileMap;
+    float tileSize;
+    TileMap tileMap;
+
     Camera2D camera;
+
+    // the obstacles that touch obstacleLayerView are drawn into a layer
+    // that is only drawn again when obstacleLayerVersion changes, which
+    // happens when they or the view change (see obstacleLayerDirty)
+    bool obstacleLayerDirty;
+    unsigned int obstacleLayerVersion;
+    Rectangle obstacleLayerView;
+
+    // fixed step simulation: rendering interpolates between the last two
+    // steps using the time since the last one
+    float fixedDelta;
+    int maxSubsteps;
+    float accumulator;
+    GameInput pendingInput;
+
+    // the input of every step is appended to record while recording and
+    // replaced by the next one of replay while replaying
+    InputRecord *record;
+    InputRecord *replay;
+
+    // drawing side, used only by the thread that draws: created on the
+    // first draw, since they need an OpenGL context
+    ParticleRenderer particleRenderer;
+    RenderTexture2D obstacleLayer;
+    unsigned int drawnObstacleLayerVersion;
     
 } GameWorld;
 
 /**
  * @brief Creates a dinamically allocated GameWorld struct instance.
  */
-GameWorld* createGameWorld( void );
+GameWorld* createGameWorld( int width, int height );
 
 /**
  * @brief Destroys a GameWindow object and its dependecies.
@@ -45,19 +128,98 @@ GameWorld* createGameWorld( void );
 void destroyGameWorld( GameWorld *gw );
 
 /**
- * @brief Reads user input and updates the state of the game.
+ * @brief Seeds the random number generators of the emitters. Each emitter
+ * gets its own stream derived from seed.
+ */
+void setSeedGameWorld( GameWorld *gw, uint64_t seed );
+
+/**
+ * @brief Starts writing the input of every following step to fileName,
+ * with what is needed to replay them on a new world. Must be called before
+ * the first step. Returns false if the file can't be written.
+ */
+bool startRecordingGameWorld( GameWorld *gw, const char *fileName );
+
+/**
+ * @brief Replaces the input of the following steps by the ones recorded in
+ * fileName, reseeding the world and choosing the obstacle backend of the
+ * recording. The world must be new and have the recorded size (see
+ * InputRecordHeader). Returns false if the recording can't be read or
+ * doesn't match the world.
+ */
+bool startReplayGameWorld( GameWorld *gw, const char *fileName );
+
+/**
+ * @brief Handles the actions that belong to the window and not to the
+ * simulation (HUD, profiler and trace). Called by the thread that draws.
+ */
+void handleWindowActionsGameWorld( const GameInput *input );
+
+/**
+ * @brief Advances the simulation by the frame time in input->delta, running
+ * as many fixed steps as fit in the accumulated time, up to maxSubsteps.
+ * Returns how many steps ran.
+ */
+int advanceGameWorld( GameWorld *gw, const GameInput *input );
+
+/**
+ * @brief Runs one simulation step of input->delta seconds. Doesn't touch
+ * the window, so it can run headless. While replaying, input is ignored
+ * and the recorded one is used until the recording ends.
+ */
+void updateGameWorld( GameWorld *gw, const GameInput *input );
+
+/**
+ * @brief Sets the simulation rate (steps per second) and how many steps
+ * a single frame may run before the remaining time is dropped.
+ */
+void setSimulationRateGameWorld( GameWorld *gw, float stepsPerSecond, int maxSubsteps );
+
+/**
+ * @brief Draws the state of the game captured in the snapshot, using the
+ * drawing side of the world.
+ */
+void drawGameWorld( GameWorld *gw, RenderSnapshot *rs );
+
+/**
+ * @brief Draws a table with the rolling statistics of each profiler zone.
+ */
+void drawProfilerGameWorld( int x, int y );
+
+/**
+ * @brief Sets how many threads (the calling one included) update the
+ * particles. 0 uses every available processor.
+ */
+void setThreadQuantityGameWorld( GameWorld *gw, int threadQuantity );
+
+/**
+ * @brief Moves the obstacles to a tile map of tileSize tiles, or back to
+ * free rectangles (one per run of tiles) if tileSize is 0.
+ */
+void setTileMapGameWorld( GameWorld *gw, float tileSize );
+
+/**
+ * @brief Bumps obstacleLayerVersion if the obstacles or the view changed
+ * since the last call and returns it.
  */
-void inputAndUpdateGameWorld( GameWorld *gw );
+unsigned int updateObstacleLayerGameWorld( GameWorld *gw );
 
 /**
- * @brief Draws the state of the game.
+ * @brief Writes the obstacles (or the runs of tiles) that touch view, up to
+ * capacity of them. Returns how many there are.
  */
-void drawGameWorld( GameWorld *gw );
+int getVisibleObstaclesGameWorld( GameWorld *gw, Rectangle view, Rectangle *rects, int capacity );
 
+void integrateParticlesGameWorld( GameWorld *gw, float delta, int pass );
+void removeDeadParticlesGameWorld( GameWorld *gw, int screenWidth, int screenHeight );
 void createObstacleGameWorld( GameWorld *gw, float delta, Vector2 pos );
-void resolveParticlesObstaclesCollision( GameWorld *gw );
+void resolveParticlesObstaclesCollision( GameWorld *gw, int pass );
 void saveObstacleData( GameWorld *gw, const char *fileName );
-void loadObstacleData( GameWorld *gw, const char *fileName );
+void exportObstacleData( GameWorld *gw, const char *fileName );
+bool loadObstacleData( GameWorld *gw, const char *fileName );
+void swapObstacleSetGameWorld( GameWorld *gw, ObstacleSet *set );
 void resetObstacles( GameWorld *gw );
-void updateCamera( Camera2D *camera );
-bool resolveParticleEmitterMouseOperations( ParticleEmitter *pe, Camera2D camera );
\ No newline at end of file
+void optimizeObstacles( GameWorld *gw );
+void updateCamera( Camera2D *camera, int screenWidth, int screenHeight );
+Rectangle getCameraView( Camera2D camera, int screenWidth, int screenHeight );
+bool resolveParticleEmitterMouseOperations( ParticleEmitter *pe, Camera2D camera, const GameInput *input );
\ No newline at end of file
@@ -0,0 +1,87 @@
+/**
+ * @file InputRecord.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Input recording struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "GameInput.h"
+
+#define INPUT_RECORD_MAGIC 0x43455250u    // "PREC" read as little endian
+#define INPUT_RECORD_VERSION 1
+
+/**
+ * @brief Start of an input recording: what a world needs, besides its
+ * inputs, to run the same steps again. It is followed by one entry per
+ * step, in the byte order of the machine that wrote it: a byte with the
+ * INPUT_RECORD_* flags of the fields that changed since the previous step,
+ * followed by those fields in flag order. stepQuantity is written when the
+ * recording is closed.
+ */
+typedef struct InputRecordHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seed;
+    int32_t width;
+    int32_t height;
+    float tileSize;
+    int32_t useTileMap;
+    int32_t stepQuantity;
+    uint32_t reserved;
+} InputRecordHeader;
+
+/**
+ * @brief Fields stored in a step entry.
+ */
+typedef enum InputRecordField {
+    INPUT_RECORD_DELTA   = 1 << 0,    // float
+    INPUT_RECORD_SCREEN  = 1 << 1,    // two int32: width and height
+    INPUT_RECORD_MOUSE   = 1 << 2,    // two floats: x and y
+    INPUT_RECORD_WHEEL   = 1 << 3,    // float
+    INPUT_RECORD_BUTTONS = 1 << 4,    // byte: left down, pressed, released, right down
+    INPUT_RECORD_ACTIONS = 1 << 5     // uint32: GameAction flags
+} InputRecordField;
+
+/**
+ * @brief An input recording being written or read, one step at a time.
+ */
+typedef struct InputRecord InputRecord;
+
+/**
+ * @brief Creates fileName and writes the header. Returns NULL if the file
+ * can't be written.
+ */
+InputRecord *createInputRecord( const char *fileName, InputRecordHeader header );
+
+/**
+ * @brief Opens a recording for reading. Returns NULL if the file can't be
+ * read or isn't an input recording.
+ */
+InputRecord *openInputRecord( const char *fileName );
+
+/**
+ * @brief Closes the recording, writing the step quantity of the header if
+ * it was being written.
+ */
+void closeInputRecord( InputRecord *record );
+
+/**
+ * @brief Returns the header of the recording.
+ */
+InputRecordHeader getHeaderInputRecord( InputRecord *record );
+
+/**
+ * @brief Appends the input of one step.
+ */
+void writeInputRecord( InputRecord *record, const GameInput *input );
+
+/**
+ * @brief Reads the input of the next step. Returns false at the end of the
+ * recording.
+ */
+bool readInputRecord( InputRecord *record, GameInput *input );
\ No newline at end of file
@@ -2,14 +2,16 @@
 
 #include "raylib/raylib.h"
 
+// the most obstacles a world can hold (a whole tile map of small tiles as
+// runs fits), files asking for more are rejected
+#define MAX_OBSTACLES ( 1 << 22 )
+
 typedef struct Obstacle {
     Rectangle rect;
-    Rectangle topCP;
-    Rectangle bottomCP;
-    Rectangle leftCP;
-    Rectangle rightCP;
     Color color;
 } Obstacle;
 
 Obstacle createObstacle( Vector2 pos, Vector2 dim, Color color );
-void drawObstacle( Obstacle *obstacle );
\ No newline at end of file
+void drawObstacle( Obstacle *obstacle );
+Rectangle *mergeRectangles( const Rectangle *rects, int quantity, int *mergedQuantity );
+int mergeObstacles( Obstacle *obstacles, int quantity );
\ No newline at end of file
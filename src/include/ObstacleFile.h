@@ -0,0 +1,67 @@
+/**
+ * @file ObstacleFile.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Binary obstacle file struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Obstacle.h"
+#include "raylib/raylib.h"
+
+#define OBSTACLE_FILE_MAGIC 0x53424F50u    // "POBS" read as little endian
+#define OBSTACLE_FILE_VERSION 2
+
+/**
+ * @brief Start of a binary obstacle file. It is followed by
+ * obstacleQuantity packed rectangles (x, y, width, height as floats), in
+ * the byte order of the machine that wrote it. checksum is the FNV-1a hash
+ * of the header (with checksum set to 0) followed by the rectangles.
+ */
+typedef struct ObstacleFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t maxObstacles;
+    int32_t obstacleQuantity;
+    Rectangle bounds;
+    uint32_t checksum;
+    uint32_t reserved;
+} ObstacleFileHeader;
+
+/**
+ * @brief A validated binary obstacle file mapped in memory. rects points
+ * straight into the mapping.
+ */
+typedef struct ObstacleFile {
+    const void *data;
+    long long size;
+    const ObstacleFileHeader *header;
+    const Rectangle *rects;
+} ObstacleFile;
+
+/**
+ * @brief Writes the obstacles in the binary format. Returns false if the
+ * file couldn't be written.
+ */
+bool saveObstacleFile( const char *fileName, const Obstacle *obstacles, int obstacleQuantity, int maxObstacles );
+
+/**
+ * @brief Maps a binary obstacle file and checks its header, size and
+ * checksum, and that maxObstacles is up to MAX_OBSTACLES. Returns false, leaving nothing mapped, if the file can't be
+ * read or isn't a valid binary obstacle file.
+ */
+bool openObstacleFile( ObstacleFile *of, const char *fileName );
+
+/**
+ * @brief Unmaps a file opened with openObstacleFile.
+ */
+void closeObstacleFile( ObstacleFile *of );
+
+/**
+ * @brief Returns true if the file starts like a binary obstacle file.
+ */
+bool isBinaryObstacleFile( const char *fileName );
\ No newline at end of file
@@ -0,0 +1,64 @@
+/**
+ * @file ObstacleGrid.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ObstacleGrid struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Obstacle.h"
+#include "raylib/raylib.h"
+
+/**
+ * @brief Uniform grid over the bounds of a set of obstacles, used as the
+ * collision broad phase. Cells are stored in compressed form: the indices
+ * of the obstacles that touch cell c are entries[cellStart[c]] up to
+ * entries[cellStart[c+1]-1].
+ */
+typedef struct ObstacleGrid {
+
+    float preferredCellSize;
+    float cellSize;
+    float originX;
+    float originY;
+    int columns;
+    int rows;
+
+    int cellCapacity;
+    int *cellStart;
+
+    int entryQuantity;
+    int entryCapacity;
+    int *entries;
+
+    // first cell (column and row) touched by each obstacle
+    int obstacleCapacity;
+    int *firstColumn;
+    int *firstRow;
+
+} ObstacleGrid;
+
+/**
+ * @brief Creates an empty grid. cellSize is the preferred cell size, it
+ * grows when the obstacles are spread over an area too big to cover.
+ */
+ObstacleGrid createObstacleGrid( float cellSize );
+
+/**
+ * @brief Destroys the grid arrays.
+ */
+void destroyObstacleGrid( ObstacleGrid *grid );
+
+/**
+ * @brief Rebuilds the grid from scratch for the given obstacles.
+ */
+void buildObstacleGrid( ObstacleGrid *grid, Obstacle *obstacles, int obstacleQuantity );
+
+/**
+ * @brief Computes the range of cells touched by rect, clamped to the grid.
+ * Returns false if rect is completely outside of the grid.
+ */
+bool getCellRangeObstacleGrid( ObstacleGrid *grid, Rectangle rect, int *firstColumn, int *firstRow, int *lastColumn, int *lastRow );
\ No newline at end of file
@@ -0,0 +1,45 @@
+/**
+ * @file ObstacleLoader.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ObstacleLoader function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "ObstacleSet.h"
+
+/**
+ * @brief Loads obstacle sets on a background thread, one at a time.
+ */
+typedef struct ObstacleLoader ObstacleLoader;
+
+/**
+ * @brief Creates an idle loader whose sets use grid cells of cellSize.
+ */
+ObstacleLoader *createObstacleLoader( float cellSize );
+
+/**
+ * @brief Waits for a running load and destroys the loader.
+ */
+void destroyObstacleLoader( ObstacleLoader *loader );
+
+/**
+ * @brief Starts loading fileName, or fallbackFileName (may be NULL) if
+ * that fails, in the background. Returns false if a load is still running.
+ */
+bool startObstacleLoader( ObstacleLoader *loader, const char *fileName, const char *fallbackFileName );
+
+/**
+ * @brief Returns true if a load is running or finished and not taken yet.
+ */
+bool isBusyObstacleLoader( ObstacleLoader *loader );
+
+/**
+ * @brief If the last load is finished, hands its set over to set (which
+ * becomes the caller's to destroy) and returns true. Returns false while
+ * loading, when idle and when the load failed.
+ */
+bool takeObstacleLoader( ObstacleLoader *loader, ObstacleSet *set );
\ No newline at end of file
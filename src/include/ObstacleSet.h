@@ -0,0 +1,43 @@
+/**
+ * @file ObstacleSet.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ObstacleSet struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Obstacle.h"
+#include "ObstacleGrid.h"
+
+/**
+ * @brief A complete set of obstacles with its collision grid, built away
+ * from the world and then swapped into it (see swapObstacleSetGameWorld).
+ */
+typedef struct ObstacleSet {
+    int maxObstacles;
+    int obstacleQuantity;
+    Obstacle *obstacles;
+    ObstacleGrid grid;
+} ObstacleSet;
+
+/**
+ * @brief Creates an empty set whose grid uses cells of cellSize.
+ */
+ObstacleSet createObstacleSet( float cellSize );
+
+/**
+ * @brief Destroys the obstacles and the grid of the set.
+ */
+void destroyObstacleSet( ObstacleSet *set );
+
+/**
+ * @brief Fills the set from a binary obstacle file (see ObstacleFile.h) or,
+ * if the file doesn't start like one, from a text file, whose obstacles
+ * are merged. Builds the grid. Returns false, with the set untouched, if
+ * the file couldn't be loaded. Only touches the set, so it can run on any
+ * thread.
+ */
+bool loadObstacleSet( ObstacleSet *set, const char *fileName );
\ No newline at end of file
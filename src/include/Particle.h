@@ -1,16 +1,55 @@
 #pragma once
 
+#include <stdbool.h>
+
 #include "raylib/raylib.h"
 
-typedef struct Particle {
-    Vector2 pos;
-    Vector2 vel;
-    float radius;
+/**
+ * @brief Structure-of-arrays particle storage. Each attribute lives in its
+ * own cache line aligned array so the integrator can stream over them with
+ * SIMD loads and stores. The awake particles come first: [0, awake) are
+ * integrated and collided, [awake, quantity) are asleep and only age.
+ */
+typedef struct ParticleStore {
+
+    int quantity;
+    int capacity;
+    int awake;
+
+    float *x;
+    float *y;
+
+    // positions at the start of the last step, used to interpolate drawing
+    float *prevX;
+    float *prevY;
+
+    float *vx;
+    float *vy;
+    float *radius;
+    Color *color;
+
+    // seconds since emission, particles older than lifetime are removed
+    float *age;
+    float lifetime;
+
+    // where and when (age) the particle started landing on the same spot,
+    // it falls asleep after landing there for REST_TIME
+    float *restX;
+    float *restY;
+    float *restAge;
+
     float friction;
     float elasticity;
-    Color color;
-} Particle;
 
-Particle createParticle( Vector2 pos, Vector2 vel, float radius, Color color );
-void updateParticle( Particle *particle, float delta );
-void drawParticle( Particle *particle );
\ No newline at end of file
+} ParticleStore;
+
+ParticleStore createParticleStore( int capacity );
+void destroyParticleStore( ParticleStore *ps );
+void setParticle( ParticleStore *ps, int index, Vector2 pos, Vector2 vel, float radius, Color color );
+void updateParticles( ParticleStore *ps, int start, int end, float delta );
+float getMaxSpeedParticles( ParticleStore *ps );
+bool updateRestParticle( ParticleStore *ps, int i );
+void settleParticles( ParticleStore *ps, float delta );
+void wakeParticle( ParticleStore *ps, int i );
+void wakeParticles( ParticleStore *ps, const Rectangle *area );
+int compactParticles( ParticleStore *ps, Rectangle bounds );
\ No newline at end of file
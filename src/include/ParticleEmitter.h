@@ -1,8 +1,11 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "Particle.h"
+#include "ParticleRenderer.h"
+#include "Random.h"
 #include "raylib/raylib.h"
 
 typedef struct ParticleEmitter {
@@ -20,19 +23,26 @@ typedef struct ParticleEmitter {
     bool draggable;
     bool mouseOver;
 
+    // fraction of a particle left over by getEmissionQuantityParticleEmitter
+    float emissionCarry;
+
     int newParticlePos;
-    int particleQuantity;
-    int maxParticles;
-    Particle *particles;
+
+    // every random value of the emitted particles comes from here
+    Random random;
+
+    ParticleStore particles;
 
 } ParticleEmitter;
 
 ParticleEmitter createParticleEmitter( Vector2 pos, Vector2 vel, float launchAngle, float posAngleVel, float hueAngleVel, float radius, bool draggable, int maxParticles );
 void destroyParticleEmitter( ParticleEmitter *pe );
-void updateParticleEmitterMoveSin( ParticleEmitter *pe, float delta );
+void updateParticleEmitterMoveSin( ParticleEmitter *pe, float delta, int screenWidth );
 void updateParticleEmitterStatic( ParticleEmitter *pe, float delta );
 void updateHueAngleBouncing( ParticleEmitter *pe, float delta );
-void drawParticleEmitter( ParticleEmitter *pe );
+void drawParticleEmitter( ParticleEmitter *pe, ParticleRenderer *pr, float alpha );
+int getEmissionQuantityParticleEmitter( ParticleEmitter *pe, float particlesPerSecond, float delta );
+void setSeedParticleEmitter( ParticleEmitter *pe, uint64_t seed );
 void emitParticle( ParticleEmitter *pe, Vector2 pos, Vector2 vel, float radius, Color color );
 void emitParticleColorInterval( ParticleEmitter *pe, Vector2 vel, float minRadius, float maxRadius, float startHue, float endHue );
 void emitParticlePositionColorInterval( ParticleEmitter *pe, Vector2 pos, Vector2 vel, float minRadius, float maxRadius, float startHue, float endHue );
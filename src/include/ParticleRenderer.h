@@ -0,0 +1,65 @@
+/**
+ * @file ParticleRenderer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ParticleRenderer struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Particle.h"
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+/**
+ * @brief Draws particles as textured quads sampling a precomputed circle
+ * texture. Each call pushes all the quads of a store into a render batch
+ * sized for it, so a whole emitter is uploaded and drawn at once instead of
+ * tessellating one triangle fan per particle.
+ * The level of detail follows the radius on screen: particles smaller than
+ * a pixel are drawn as one pixel lines, the ones bigger than the texture
+ * as circles with as many segments as their perimeter needs.
+ */
+typedef struct ParticleRenderer {
+
+    bool initialized;
+    Texture2D circleTexture;
+    rlRenderBatch batch;
+    int batchCapacity;
+
+    // part of the world on the screen and screen pixels per world unit
+    // in the current frame, particles outside of view are skipped
+    Rectangle view;
+    float zoom;
+
+    // particles (the visible ones) and vertices drawn in the current frame
+    int drawnParticles;
+    int drawnVertices;
+
+} ParticleRenderer;
+
+/**
+ * @brief Creates the circle texture and a render batch able to hold
+ * maxParticles quads. Needs an OpenGL context.
+ */
+ParticleRenderer createParticleRenderer( int maxParticles );
+
+/**
+ * @brief Unloads the texture and the render batch.
+ */
+void destroyParticleRenderer( ParticleRenderer *pr );
+
+/**
+ * @brief Resets the per frame draw statistics and sets the world view
+ * (used for culling) and zoom of the camera the particles will be drawn
+ * with.
+ */
+void beginFrameParticleRenderer( ParticleRenderer *pr, Rectangle view, float zoom );
+
+/**
+ * @brief Draws every particle of the store in a single batch, at
+ * alpha (0 to 1) of the way between its previous and current positions.
+ */
+void drawParticlesParticleRenderer( ParticleRenderer *pr, ParticleStore *ps, float alpha );
\ No newline at end of file
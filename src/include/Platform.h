@@ -0,0 +1,39 @@
+/**
+ * @file Platform.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Operating system services that raylib does not provide.
+ * 
+ * This header must not include raylib.h nor the system headers, since
+ * windows.h and raylib.h can't be used in the same compilation unit.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+/**
+ * @brief Returns the time, in seconds, of a monotonic high resolution
+ * clock. Works without a window, unlike raylib GetTime.
+ */
+double getTimePlatform( void );
+
+/**
+ * @brief Suspends the calling thread for about the given time.
+ */
+void sleepPlatform( double seconds );
+
+/**
+ * @brief Returns the number of logical processors available.
+ */
+int getProcessorCountPlatform( void );
+
+/**
+ * @brief Maps a whole file in memory, read only. Returns NULL if the file
+ * can't be opened or is empty; otherwise *size receives its size in
+ * bytes. Release it with unmapFilePlatform.
+ */
+const void *mapFilePlatform( const char *fileName, long long *size );
+
+/**
+ * @brief Releases a file mapped with mapFilePlatform.
+ */
+void unmapFilePlatform( const void *data, long long size );
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ * @file Profiler.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Profiler struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+// how many frames the rolling statistics look at
+#define PROFILER_WINDOW_SIZE 240
+
+/**
+ * @brief The timed phases of a frame. The simulation ones come first and
+ * are sampled per step, the drawing ones per frame.
+ */
+typedef enum ProfilerZone {
+    PROFILER_ZONE_EMIT,
+    PROFILER_ZONE_INTEGRATE,
+    PROFILER_ZONE_COLLISION,
+    PROFILER_ZONE_COMPACT,
+    PROFILER_ZONE_OBSTACLE_DRAW,
+    PROFILER_ZONE_PARTICLE_DRAW,
+    PROFILER_ZONE_PRESENT,
+    PROFILER_ZONE_FRAME,
+    PROFILER_ZONE_COUNT
+} ProfilerZone;
+
+// zones below this one run in the simulation thread, once per step
+#define PROFILER_STEP_ZONE_COUNT PROFILER_ZONE_OBSTACLE_DRAW
+
+/**
+ * @brief Statistics of a zone over the rolling window, in seconds.
+ */
+typedef struct ProfilerStats {
+    double mean;
+    double p50;
+    double p99;
+    double max;
+} ProfilerStats;
+
+typedef struct Profiler {
+
+    double start[PROFILER_ZONE_COUNT];
+    double total[PROFILER_ZONE_COUNT];
+    long long calls[PROFILER_ZONE_COUNT];
+
+    // time spent in each zone since the last endStepProfiler call (the
+    // simulation zones) or endFrameProfiler call (the others)
+    double current[PROFILER_ZONE_COUNT];
+    double frameStart;
+
+    // per step times of the simulation zones and per frame times of the
+    // others, each kind in its own ring
+    double samples[PROFILER_ZONE_COUNT][PROFILER_WINDOW_SIZE];
+    int sampleQuantity;
+    int nextSample;
+    int stepSampleQuantity;
+    int nextStepSample;
+
+} Profiler;
+
+/**
+ * @brief Global Profiler instance.
+ */
+extern Profiler profiler;
+
+void beginProfilerZone( ProfilerZone zone );
+void endProfilerZone( ProfilerZone zone );
+void resetProfiler( void );
+const char *getNameProfilerZone( ProfilerZone zone );
+
+/**
+ * @brief Closes the current frame: the times of the drawing zones go to
+ * their rolling window and the frame zone gets the time since the previous
+ * call.
+ */
+void endFrameProfiler( void );
+
+/**
+ * @brief Closes the current simulation step: the times of the simulation
+ * zones go to their rolling window. Called by the thread that steps, so
+ * the statistics measure steps whatever the drawing rate.
+ */
+void endStepProfiler( void );
+
+/**
+ * @brief Mean, median, 99th percentile and maximum of a zone over the
+ * steps (or frames, for the drawing zones) in its rolling window.
+ */
+ProfilerStats getStatsProfilerZone( ProfilerZone zone );
+
+/**
+ * @brief Writes the rolling windows to a CSV file, one column per zone, in
+ * milliseconds. Line k holds the k-th oldest step of the simulation zones
+ * and the k-th oldest frame of the others, empty if there is none.
+ */
+bool saveCSVProfiler( const char *fileName );
\ No newline at end of file
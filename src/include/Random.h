@@ -0,0 +1,46 @@
+/**
+ * @file Random.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Random struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief xorshift64* pseudo random number generator. Each user owns its
+ * own state, so there is no shared generator to serialize on and a run can
+ * be reproduced from its seed.
+ */
+typedef struct Random {
+    uint64_t state;
+} Random;
+
+/**
+ * @brief Creates a generator. The seed is scrambled with splitmix64, so
+ * close seeds (like seed, seed + 1, ...) give unrelated sequences.
+ */
+Random createRandom( uint64_t seed );
+
+/**
+ * @brief Next 64 random bits.
+ */
+uint64_t nextRandom( Random *random );
+
+/**
+ * @brief Uniform float between min and max.
+ */
+float nextFloatRandom( Random *random, float min, float max );
+
+/**
+ * @brief Fills values with quantity uniform floats between min and max.
+ */
+void fillFloatRandom( Random *random, float *values, int quantity, float min, float max );
+
+/**
+ * @brief Flips the sign of each value with probability 1/2, using one bit
+ * per value.
+ */
+void flipSignRandom( Random *random, float *values, int quantity );
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ * @file RenderSnapshot.h
+ * @author Prof. Dr. David Buzatto
+ * @brief RenderSnapshot struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "ParticleEmitter.h"
+#include "raylib/raylib.h"
+
+struct GameWorld;
+
+/**
+ * @brief Copy of everything drawGameWorld needs from the world after a
+ * simulation step, so the world can keep stepping in another thread while
+ * the copy is drawn.
+ */
+typedef struct RenderSnapshot {
+
+    // platform time when the last step ended, drawing interpolates
+    // between the previous and the current positions from there
+    double time;
+    float fixedDelta;
+
+    Camera2D camera;
+
+    // copies of the emitters: their particle stores only hold the
+    // positions, radii and colors
+    int emittersQuantity;
+    ParticleEmitter *emitters;
+
+    // obstacles (or runs of tiles) that touch obstacleView, recopied only
+    // when obstacleVersion changes
+    unsigned int obstacleVersion;
+    Rectangle obstacleView;
+    int obstacleQuantity;
+    int obstacleCapacity;
+    Rectangle *obstacles;
+
+    // for the HUD
+    bool useTileMap;
+    int tileQuantity;
+    int totalObstacles;
+    bool loadingObstacles;
+
+} RenderSnapshot;
+
+/**
+ * @brief Creates an empty snapshot.
+ */
+RenderSnapshot createRenderSnapshot( void );
+
+/**
+ * @brief Destroys the copies held by the snapshot.
+ */
+void destroyRenderSnapshot( RenderSnapshot *rs );
+
+/**
+ * @brief Copies the current state of the world to the snapshot. time is
+ * the platform time when the last step ended.
+ */
+void captureRenderSnapshot( RenderSnapshot *rs, struct GameWorld *gw, double time );
\ No newline at end of file
@@ -0,0 +1,45 @@
+/**
+ * @file SimulationThread.h
+ * @author Prof. Dr. David Buzatto
+ * @brief SimulationThread function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include "GameInput.h"
+#include "GameWorld.h"
+#include "RenderSnapshot.h"
+
+/**
+ * @brief Runs the fixed step simulation of a world in its own thread. The
+ * inputs arrive through a lock free queue and each batch of steps is
+ * published as a render snapshot through a triple buffer, so neither the
+ * simulation nor the drawing waits for the other.
+ */
+typedef struct SimulationThread SimulationThread;
+
+/**
+ * @brief Publishes a first snapshot of the world and starts simulating
+ * it. From here on the world belongs to the simulation thread. Returns
+ * NULL if the thread can't be created.
+ */
+SimulationThread *createSimulationThread( GameWorld *gw );
+
+/**
+ * @brief Stops and joins the thread and destroys the snapshots. The world
+ * is left as it was after the last step.
+ */
+void destroySimulationThread( SimulationThread *st );
+
+/**
+ * @brief Sends the input of a frame to the simulation. Inputs that don't
+ * fit in the queue are merged and sent with the next one.
+ */
+void pushInputSimulationThread( SimulationThread *st, const GameInput *input );
+
+/**
+ * @brief Returns the newest published snapshot. It stays valid, and isn't
+ * written to, until the next call.
+ */
+RenderSnapshot *getSnapshotSimulationThread( SimulationThread *st );
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ * @file TileMap.h
+ * @author Prof. Dr. David Buzatto
+ * @brief TileMap struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Obstacle.h"
+#include "raylib/raylib.h"
+
+/**
+ * @brief Dense occupancy grid of square tiles, an alternative to the free
+ * rectangle obstacles. Finding what a particle touches is just indexing
+ * the (at most four, if its diameter is up to tileSize) tiles under it, so
+ * collision costs the same no matter how many tiles are solid.
+ */
+typedef struct TileMap {
+
+    float tileSize;
+    float originX;
+    float originY;
+    int columns;
+    int rows;
+
+    // one byte per tile, row by row, not zero if solid
+    unsigned char *tiles;
+    int solidQuantity;
+
+    // tile range containing every solid tile, empty if first > last
+    int firstColumn;
+    int firstRow;
+    int lastColumn;
+    int lastRow;
+
+} TileMap;
+
+/**
+ * @brief Creates an empty map of columns x rows tiles whose top left
+ * corner is at (originX, originY).
+ */
+TileMap createTileMap( float tileSize, float originX, float originY, int columns, int rows );
+
+/**
+ * @brief Destroys the tile array.
+ */
+void destroyTileMap( TileMap *tm );
+
+/**
+ * @brief Makes every tile empty.
+ */
+void clearTileMap( TileMap *tm );
+
+/**
+ * @brief Returns true if the tile exists and is solid.
+ */
+bool isSolidTileMap( TileMap *tm, int column, int row );
+
+/**
+ * @brief Recounts the solid tiles and the range that contains them, after
+ * the tiles were written directly.
+ */
+void updateBoundsTileMap( TileMap *tm );
+
+/**
+ * @brief Makes solid every tile whose center is inside rect.
+ */
+void fillTileMap( TileMap *tm, Rectangle rect );
+
+/**
+ * @brief Clears the map and fills it with the given obstacles.
+ */
+void rasterizeObstaclesTileMap( TileMap *tm, Obstacle *obstacles, int obstacleQuantity );
+
+/**
+ * @brief Writes the solid tiles as rectangles, one per horizontal run of
+ * solid tiles, up to capacity of them. Returns how many runs there are.
+ */
+int getRunsTileMap( TileMap *tm, Rectangle *runs, int capacity );
+
+/**
+ * @brief Area covered by the solid tiles. Returns false if there is none.
+ */
+bool getBoundsTileMap( TileMap *tm, Rectangle *bounds );
+
+/**
+ * @brief Like getRunsTileMap, but only for the tiles inside view (the runs
+ * are clipped to it).
+ */
+int getViewRunsTileMap( TileMap *tm, Rectangle view, Rectangle *runs, int capacity );
\ No newline at end of file
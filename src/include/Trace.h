@@ -0,0 +1,87 @@
+/**
+ * @file Trace.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Trace struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+// lanes (thread ids) of the trace: the worker that runs part n of the
+// worker pool jobs records in TRACE_WORKER_THREAD + n - 1
+#define TRACE_MAIN_THREAD 0
+#define TRACE_SIMULATION_THREAD 1
+#define TRACE_WORKER_THREAD 2
+
+/**
+ * @brief A complete zone: what ran, on which thread and when (seconds).
+ */
+typedef struct TraceEvent {
+    const char *name;
+    int thread;
+    double start;
+    double end;
+} TraceEvent;
+
+/**
+ * @brief Records zones of a number of frames and writes them as Chrome
+ * trace event JSON, which chrome://tracing and Perfetto open. Each thread
+ * records in its own lane, see setThreadTrace.
+ */
+typedef struct Trace {
+
+    bool active;
+    const char *fileName;
+    int remainingFrames;
+    double origin;
+    double frameStart;
+
+    // filled concurrently by every thread, see endTraceZone
+    TraceEvent *events;
+    int eventCapacity;
+    int eventQuantity;
+
+} Trace;
+
+/**
+ * @brief Global Trace instance.
+ */
+extern Trace trace;
+
+/**
+ * @brief Starts recording the next frameQuantity frames. The file is
+ * written when they are done or when stopTrace is called. Does nothing if
+ * a trace is already running.
+ */
+void startTrace( const char *fileName, int frameQuantity );
+
+/**
+ * @brief Writes the recorded events and stops the trace, if running.
+ */
+void stopTrace( void );
+
+/**
+ * @brief Start time of a zone, to be passed to endTraceZone. Cheap when
+ * not tracing.
+ */
+double beginTraceZone( void );
+
+/**
+ * @brief Records a zone that began at start in the lane of the calling
+ * thread. name must be a string that lives until the trace is written (a
+ * literal). Thread safe.
+ */
+void endTraceZone( const char *name, double start );
+
+/**
+ * @brief Sets the lane the calling thread records in (TRACE_MAIN_THREAD
+ * by default).
+ */
+void setThreadTrace( int thread );
+
+/**
+ * @brief Records the frame zone and counts one traced frame.
+ */
+void endFrameTrace( void );
\ No newline at end of file
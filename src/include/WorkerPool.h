@@ -0,0 +1,44 @@
+/**
+ * @file WorkerPool.h
+ * @author Prof. Dr. David Buzatto
+ * @brief WorkerPool function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+/**
+ * @brief Processes the items in [start, end). part identifies which slice
+ * of the job is running (0 is always the calling thread).
+ */
+typedef void (*WorkerTask)( void *context, int start, int end, int part );
+
+/**
+ * @brief Persistent pool of threads that split index ranges among
+ * themselves. The threads are created once and sleep between jobs.
+ */
+typedef struct WorkerPool WorkerPool;
+
+/**
+ * @brief Creates a pool with workerQuantity extra threads. The thread
+ * that runs the jobs also works, so the pool uses workerQuantity + 1 cores.
+ */
+WorkerPool *createWorkerPool( int workerQuantity );
+
+/**
+ * @brief Stops and joins the threads and destroys the pool.
+ */
+void destroyWorkerPool( WorkerPool *pool );
+
+/**
+ * @brief Splits [0, itemQuantity) in contiguous slices of at least
+ * minItemsPerPart items, runs task over them in parallel and waits for all
+ * of them to finish. Small jobs run on the calling thread only.
+ */
+void runWorkerPool( WorkerPool *pool, WorkerTask task, void *context, int itemQuantity, int minItemsPerPart );
+
+/**
+ * @brief Number of threads (the calling one included) that take part in
+ * the jobs.
+ */
+int getThreadQuantityWorkerPool( WorkerPool *pool );
\ No newline at end of file
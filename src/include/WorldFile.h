@@ -0,0 +1,98 @@
+/**
+ * @file WorldFile.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Binary world snapshot struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "GameWorld.h"
+#include "raylib/raylib.h"
+
+#define WORLD_FILE_MAGIC 0x444C5750u    // "PWLD" read as little endian
+#define WORLD_FILE_VERSION 3
+
+/**
+ * @brief Start of a world snapshot, in the byte order of the machine that
+ * wrote it. It is followed by emittersQuantity emitters, each one a
+ * WorldFileEmitter and its particle arrays (x, y, prevX, prevY, vx, vy,
+ * radius, color, age, restX, restY and restAge, quantity elements each), then obstacleQuantity
+ * Obstacle structs of obstacleSize bytes and, if useTileMap is set, the
+ * tileColumns * tileRows tile bytes. The solid tile count and bounds are
+ * recomputed from the tiles when loading.
+ */
+typedef struct WorldFileHeader {
+
+    uint32_t magic;
+    uint32_t version;
+
+    uint64_t seed;
+    int32_t width;
+    int32_t height;
+    Camera2D camera;
+
+    int32_t emittersQuantity;
+
+    int32_t obstacleSize;
+    int32_t maxObstacles;
+    int32_t obstacleQuantity;
+    int32_t newObstaclePos;
+    float obstacleCounter;
+    int32_t paintingObstacles;
+
+    int32_t useTileMap;
+    float tileSize;
+    float tileOriginX;
+    float tileOriginY;
+    int32_t tileColumns;
+    int32_t tileRows;
+
+} WorldFileHeader;
+
+/**
+ * @brief Emitter state stored before its particles.
+ */
+typedef struct WorldFileEmitter {
+
+    Vector2 pos;
+    Vector2 vel;
+    float launchAngle;
+    float posAngle;
+    float posAngleVel;
+    float hueAngle;
+    float hueAngleVel;
+    float radius;
+    int32_t dragging;
+    float emissionCarry;
+    int32_t newParticlePos;
+    uint64_t random;
+
+    int32_t quantity;
+    int32_t capacity;
+    int32_t awake;
+    float lifetime;
+    float friction;
+    float elasticity;
+
+} WorldFileEmitter;
+
+/**
+ * @brief Writes the state of the world (emitters, particles, obstacles,
+ * tile map and camera) with one write per array. Must be called between
+ * steps. Returns false if the file couldn't be written.
+ */
+bool saveWorldFile( GameWorld *gw, const char *fileName );
+
+/**
+ * @brief Maps a snapshot written by saveWorldFile and copies it into the
+ * world, one copy per array. Must be called between steps. Returns false,
+ * with the world untouched, if the file can't be read, isn't a valid
+ * snapshot (sizes and indices included), there is no memory for its
+ * obstacles or it was written by a world with other emitters (or emitters
+ * with another capacity).
+ */
+bool loadWorldFile( GameWorld *gw, const char *fileName );
\ No newline at end of file
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <stddef.h>
+
 #include "raylib/raylib.h"
 
 #define min( x, y ) (x) < (y) ? x : y;
@@ -14,4 +16,14 @@
 
 double toRadians( double degrees );
 double toDegrees( double radians );
-Vector2 createVel( float velX, float velY, bool randomSignX, bool randomSignY );
\ No newline at end of file
+
+/**
+ * @brief Allocates a block of memory whose address is a multiple of
+ * alignment (a power of two). Must be released with freeAligned.
+ */
+void *allocAligned( size_t size, size_t alignment );
+
+/**
+ * @brief Releases a block allocated with allocAligned.
+ */
+void freeAligned( void *ptr );
\ No newline at end of file
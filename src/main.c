@@ -3,22 +3,122 @@
  * @author Prof. Dr. David Buzatto
  * @brief Main function and logic for the game. Base template for game
  * development in C using Raylib (https://www.raylib.com/).
- * 
+ *
+ * Usage:
+ *    Particles [options]: opens the game window. Options:
+ *       --fps <n>: target frames per second (default 60)
+ *       --sim-rate <n>: simulation steps per second (default 60)
+ *       --max-substeps <n>: simulation steps allowed per frame (default 8)
+ *       --threads <n>: threads updating the particles (default: one per
+ *          processor), also valid for --headless
+ *       --tiles <px>: uses the tile map obstacle backend with tiles of
+ *          the given size (F4 toggles it), also valid for --headless
+ *       --trace <n>: writes the first n frames (steps when headless) to
+ *          trace.json, in Chrome trace event format, also valid for
+ *          --headless
+ *       --load-world <file>: starts from a world snapshot saved with F9
+ *          (world.bin) or --save-world, also valid for --headless
+ *       --record <file>: writes the seed and the input of every step to
+ *          file, also valid for --headless
+ *       --replay <file>: runs the steps recorded in file with --record,
+ *          with the same results, then goes back to the live input (ends
+ *          the run when headless). Files loaded with F6, F10, --obstacles
+ *          or --load-world are read again, so they must not have changed.
+ *          Also valid for --headless
+ *    Particles --headless [options]: runs the simulation without a window
+ *       and prints the benchmark results. Options:
+ *       --steps <n>: number of fixed steps (default 600)
+ *       --delta <seconds>: step duration (default 1/60)
+ *       --width <px> --height <px>: world size (default 800x450)
+ *       --seed <n>: random seed (default 1)
+ *       --script: emulates mouse painting and emission
+ *       --obstacles <file>: loads an obstacle file before the first step
+ *       --save-world <file>: writes a world snapshot after the last step
+ *
  * @copyright Copyright (c) 2024
  */
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
+#include "Benchmark.h"
 #include "GameWindow.h"
 
-int main( void ) {
+int main( int argc, char **argv ) {
+
+    bool headless = false;
+    int targetFPS = 60;
+    float simulationRate = 60.0f;
+    int maxSubsteps = 8;
+    int threadQuantity = 0;
+    int traceFrames = 0;
+    float tileSize = 0.0f;
+    const char *worldFile = NULL;
+    const char *recordFile = NULL;
+    const char *replayFile = NULL;
+    BenchmarkConfig benchmarkConfig = createBenchmarkConfig();
+
+    for ( int i = 1; i < argc; i++ ) {
+        bool hasValue = i + 1 < argc;
+        if ( strcmp( argv[i], "--headless" ) == 0 ) {
+            headless = true;
+        } else if ( strcmp( argv[i], "--fps" ) == 0 && hasValue ) {
+            targetFPS = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--sim-rate" ) == 0 && hasValue ) {
+            simulationRate = (float) atof( argv[++i] );
+        } else if ( strcmp( argv[i], "--max-substeps" ) == 0 && hasValue ) {
+            maxSubsteps = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--threads" ) == 0 && hasValue ) {
+            threadQuantity = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--tiles" ) == 0 && hasValue ) {
+            tileSize = (float) atof( argv[++i] );
+        } else if ( strcmp( argv[i], "--trace" ) == 0 && hasValue ) {
+            traceFrames = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--load-world" ) == 0 && hasValue ) {
+            worldFile = argv[++i];
+        } else if ( strcmp( argv[i], "--record" ) == 0 && hasValue ) {
+            recordFile = argv[++i];
+        } else if ( strcmp( argv[i], "--replay" ) == 0 && hasValue ) {
+            replayFile = argv[++i];
+        } else if ( strcmp( argv[i], "--steps" ) == 0 && hasValue ) {
+            benchmarkConfig.steps = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--delta" ) == 0 && hasValue ) {
+            benchmarkConfig.delta = (float) atof( argv[++i] );
+        } else if ( strcmp( argv[i], "--width" ) == 0 && hasValue ) {
+            benchmarkConfig.width = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--height" ) == 0 && hasValue ) {
+            benchmarkConfig.height = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "--seed" ) == 0 && hasValue ) {
+            benchmarkConfig.seed = (unsigned int) strtoul( argv[++i], NULL, 10 );
+        } else if ( strcmp( argv[i], "--script" ) == 0 ) {
+            benchmarkConfig.scriptedInput = true;
+        } else if ( strcmp( argv[i], "--obstacles" ) == 0 && hasValue ) {
+            benchmarkConfig.obstaclesFile = argv[++i];
+        } else if ( strcmp( argv[i], "--save-world" ) == 0 && hasValue ) {
+            benchmarkConfig.savedWorldFile = argv[++i];
+        } else {
+            fprintf( stderr, "unknown or incomplete option: %s\n", argv[i] );
+            return 1;
+        }
+    }
+
+    if ( headless ) {
+        benchmarkConfig.threadQuantity = threadQuantity;
+        benchmarkConfig.traceFrames = traceFrames;
+        benchmarkConfig.tileSize = tileSize;
+        benchmarkConfig.worldFile = worldFile;
+        benchmarkConfig.recordFile = recordFile;
+        benchmarkConfig.replayFile = replayFile;
+        runBenchmark( benchmarkConfig );
+        return 0;
+    }
 
     GameWindow *gameWindow = createGameWindow(
         800,             // width
         450,             // height
         "Particles",     // title
-        60,              // target FPS
+        targetFPS,       // target FPS
         true,            // antialiasing
         true,            // resizable
         false,           // full screen
@@ -29,6 +129,15 @@ int main( void ) {
         false            // init audio
     );
 
+    gameWindow->simulationRate = simulationRate > 0.0f ? simulationRate : 60.0f;
+    gameWindow->maxSubsteps = maxSubsteps;
+    gameWindow->threadQuantity = threadQuantity;
+    gameWindow->tileSize = tileSize;
+    gameWindow->traceFrames = traceFrames;
+    gameWindow->worldFile = worldFile;
+    gameWindow->recordFile = recordFile;
+    gameWindow->replayFile = replayFile;
+
     initGameWindow( gameWindow );
 
     return 0;
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "utils.h"
 #include "raylib/raylib.h"
@@ -20,14 +21,25 @@ double toDegrees( double radians ) {
     return radians * 180.0 / PI;
 }
 
-Vector2 createVel( float velX, float velY, bool randomSignX, bool randomSignY ) {
-    
-    float multX = randomSignX ? ( GetRandomValue( 0, 1 ) == 0 ? 1.0 : -1.0 ) : 1.0;
-    float multY = randomSignY ? ( GetRandomValue( 0, 1 ) == 0 ? 1.0 : -1.0 ) : 1.0;
+void *allocAligned( size_t size, size_t alignment ) {
 
-    return (Vector2) {
-        velX * multX,
-        velY * multY
-    };
+    // the original pointer is kept just before the aligned block
+    void *raw = malloc( size + alignment + sizeof( void* ) );
 
+    if ( raw == NULL ) {
+        return NULL;
+    }
+
+    uintptr_t start = (uintptr_t) raw + sizeof( void* );
+    uintptr_t aligned = ( start + alignment - 1 ) & ~( (uintptr_t) alignment - 1 );
+    ( (void**) aligned )[-1] = raw;
+
+    return (void*) aligned;
+
+}
+
+void freeAligned( void *ptr ) {
+    if ( ptr != NULL ) {
+        free( ( (void**) ptr )[-1] );
+    }
 }
\ No newline at end of file